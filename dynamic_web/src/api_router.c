@@ -0,0 +1,141 @@
+#include "api_router.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/http/status.h>
+#include <zephyr/sys/util.h>
+
+#define API_ROUTE_KEY_MAX 32
+
+/*
+ * Map "/api/metrics/archive?x" to the sort key "metrics_archive_". A literal
+ * '_' in the path is rejected so /api/metrics_archive cannot alias the route.
+ */
+static bool route_key_from_url(const char *url, char *key, size_t key_len)
+{
+	size_t len = 0U;
+
+	if (strncmp(url, API_ROUTER_PREFIX, strlen(API_ROUTER_PREFIX)) != 0) {
+		return false;
+	}
+
+	for (url += strlen(API_ROUTER_PREFIX); (*url != '\0') && (*url != '?'); url++) {
+		if ((len + 2U > key_len) || (*url == '_')) {
+			return false;
+		}
+		key[len++] = (*url == '/') ? '_' : *url;
+	}
+
+	key[len++] = '_';
+	key[len] = '\0';
+	return true;
+}
+
+static const struct api_route *route_find(const char *url)
+{
+	char key[API_ROUTE_KEY_MAX];
+	const struct api_route *route;
+	int low = 0;
+	int high;
+	int cmp;
+
+	if (!route_key_from_url(url, key, sizeof(key))) {
+		return NULL;
+	}
+
+	STRUCT_SECTION_COUNT(api_route, &high);
+	high--;
+
+	while (low <= high) {
+		int mid = low + ((high - low) / 2);
+
+		STRUCT_SECTION_GET(api_route, mid, &route);
+		cmp = strcmp(key, route->sort_key);
+		if (cmp == 0) {
+			return route;
+		}
+
+		if (cmp < 0) {
+			high = mid - 1;
+		} else {
+			low = mid + 1;
+		}
+	}
+
+	return NULL;
+}
+
+bool api_router_query_param(const char *url, const char *name, const char **value,
+			    size_t *value_len)
+{
+	const char *param = strchr(url, '?');
+	size_t name_len = strlen(name);
+
+	while (param != NULL) {
+		param++;
+		if ((strncmp(param, name, name_len) == 0) && (param[name_len] == '=')) {
+			*value = &param[name_len + 1];
+			*value_len = strcspn(*value, "&#");
+			return true;
+		}
+
+		param = strchr(param, '&');
+	}
+
+	return false;
+}
+
+bool api_router_query_param_u32(const char *url, const char *name, uint32_t *value)
+{
+	const char *str;
+	uint32_t result = 0U;
+	size_t len;
+
+	if (!api_router_query_param(url, name, &str, &len) || (len == 0U)) {
+		return false;
+	}
+
+	/* Digits only: strtoul() would accept a sign, whitespace and wrap "-1". */
+	for (size_t i = 0; i < len; i++) {
+		uint32_t digit = (uint32_t)(str[i] - '0');
+
+		if ((digit > 9U) || (result > (UINT32_MAX - digit) / 10U)) {
+			return false;
+		}
+
+		result = (result * 10U) + digit;
+	}
+
+	*value = result;
+	return true;
+}
+
+int api_router_cb(struct http_client_ctx *client, enum http_data_status status,
+		  const struct http_request_ctx *request_ctx,
+		  struct http_response_ctx *response_ctx, void *user_data)
+{
+	const struct api_route *route = route_find(client->url_buffer);
+	int ret;
+
+	ARG_UNUSED(user_data);
+
+	if ((route == NULL) || ((route->methods & BIT(client->method)) == 0U)) {
+		if (status == HTTP_SERVER_DATA_FINAL) {
+			response_ctx->status = (route == NULL) ? HTTP_404_NOT_FOUND
+							       : HTTP_405_METHOD_NOT_ALLOWED;
+			response_ctx->final_chunk = true;
+		}
+		return 0;
+	}
+
+	ret = route->cb(client, status, request_ctx, response_ctx, route->user_data);
+
+	/* Handlers that set their own headers (e.g. 429) also own Content-Type. */
+	if ((ret == 0) && (response_ctx->header_count == 0U)) {
+		response_ctx->headers = &route->content_type;
+		response_ctx->header_count = 1U;
+	}
+
+	return ret;
+}
@@ -0,0 +1,46 @@
+#ifndef API_ROUTER_H
+#define API_ROUTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/net/http/server.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#define API_ROUTER_PREFIX "/api/"
+
+struct api_route {
+	/* Route key followed by '_', matching the linker's section sort key. */
+	const char *sort_key;
+	uint32_t methods;
+	struct http_header content_type;
+	http_resource_dynamic_cb_t cb;
+	void *user_data;
+};
+
+/*
+ * Register a handler for API_ROUTER_PREFIX "<key>", where '_' in the key
+ * stands for '/' in the path, e.g. metrics_archive -> /api/metrics/archive.
+ * Routes are placed in an iterable section that the linker sorts by key,
+ * so the dispatcher can binary search them.
+ */
+#define API_ROUTE_DEFINE(_key, _methods, _content_type, _cb)                                  \
+	static const STRUCT_SECTION_ITERABLE_NAMED(api_route, _key, api_route_##_key) = {     \
+		.sort_key = #_key "_",                                                         \
+		.methods = (_methods),                                                         \
+		.content_type = { .name = "Content-Type", .value = (_content_type) },          \
+		.cb = (_cb),                                                                   \
+	}
+
+/* Find query parameter `name` in url; value is not NUL-terminated. */
+bool api_router_query_param(const char *url, const char *name, const char **value,
+			    size_t *value_len);
+bool api_router_query_param_u32(const char *url, const char *name, uint32_t *value);
+
+/* Dynamic resource callback for API_ROUTER_PREFIX "*". */
+int api_router_cb(struct http_client_ctx *client, enum http_data_status status,
+		  const struct http_request_ctx *request_ctx,
+		  struct http_response_ctx *response_ctx, void *user_data);
+
+#endif
@@ -1,7 +1,28 @@
 #include "app_utils.h"
 
+#include <errno.h>
+
 #include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
 #include <zephyr/sys/sys_heap.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(app_utils, LOG_LEVEL_INF);
+
+K_HEAP_DEFINE(app_http_heap, CONFIG_APP_HTTP_HEAP_SIZE);
+K_HEAP_DEFINE(app_fs_heap, CONFIG_APP_FS_HEAP_SIZE);
+K_HEAP_DEFINE(app_metrics_heap, CONFIG_APP_METRICS_HEAP_SIZE);
+
+struct app_heap_entry {
+	const char *name;
+	struct k_heap *heap;
+};
+
+static const struct app_heap_entry app_heaps[APP_HEAP_COUNT] = {
+	[APP_HEAP_HTTP] = { "http", &app_http_heap },
+	[APP_HEAP_FS] = { "fs", &app_fs_heap },
+	[APP_HEAP_METRICS] = { "metrics", &app_metrics_heap },
+};
 
 int app_utils_get_cpu_util_percent(void)
 {
@@ -65,3 +86,46 @@ int app_utils_get_ram_util_percent(void)
 	return -1;
 #endif
 }
+
+void *app_utils_heap_alloc(enum app_heap heap, size_t size)
+{
+	void *ptr = k_heap_alloc(app_heaps[heap].heap, size, K_NO_WAIT);
+
+	if (ptr == NULL) {
+		LOG_WRN("%s heap exhausted (%zu bytes requested)", app_heaps[heap].name, size);
+	}
+
+	return ptr;
+}
+
+void app_utils_heap_free(enum app_heap heap, void *ptr)
+{
+	k_heap_free(app_heaps[heap].heap, ptr);
+}
+
+const char *app_utils_heap_name(enum app_heap heap)
+{
+	return app_heaps[heap].name;
+}
+
+int app_utils_get_heap_stats(enum app_heap heap, struct app_heap_stats *stats)
+{
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+	struct sys_memory_stats sys_stats;
+	int ret;
+
+	ret = sys_heap_runtime_stats_get(&app_heaps[heap].heap->heap, &sys_stats);
+	if (ret < 0) {
+		return ret;
+	}
+
+	stats->allocated_bytes = sys_stats.allocated_bytes;
+	stats->free_bytes = sys_stats.free_bytes;
+	stats->max_allocated_bytes = sys_stats.max_allocated_bytes;
+	return 0;
+#else
+	ARG_UNUSED(heap);
+	ARG_UNUSED(stats);
+	return -ENOTSUP;
+#endif
+}
@@ -1,7 +1,28 @@
 #ifndef APP_UTILS_H
 #define APP_UTILS_H
 
+#include <stddef.h>
+
+/* Dedicated heaps, so one subsystem running out does not starve the others. */
+enum app_heap {
+	APP_HEAP_HTTP,
+	APP_HEAP_FS,
+	APP_HEAP_METRICS,
+	APP_HEAP_COUNT,
+};
+
+struct app_heap_stats {
+	size_t allocated_bytes;
+	size_t free_bytes;
+	size_t max_allocated_bytes;
+};
+
 int app_utils_get_cpu_util_percent(void);
 int app_utils_get_ram_util_percent(void);
 
+void *app_utils_heap_alloc(enum app_heap heap, size_t size);
+void app_utils_heap_free(enum app_heap heap, void *ptr);
+const char *app_utils_heap_name(enum app_heap heap);
+int app_utils_get_heap_stats(enum app_heap heap, struct app_heap_stats *stats);
+
 #endif
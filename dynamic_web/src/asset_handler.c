@@ -0,0 +1,551 @@
+#include "asset_handler.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#if defined(CONFIG_MCUMGR_GRP_FS_FILE_ACCESS_HOOK)
+#include <zephyr/mgmt/mcumgr/grp/fs_mgmt/fs_mgmt_callbacks.h>
+#include <zephyr/mgmt/mcumgr/mgmt/callbacks.h>
+#endif
+#include <zephyr/net/http/status.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#include "app_utils.h"
+#include "filesystem_service.h"
+
+LOG_MODULE_REGISTER(asset_handler, LOG_LEVEL_INF);
+
+HTTP_SERVER_REGISTER_HEADER_CAPTURE(capture_range, "Range");
+HTTP_SERVER_REGISTER_HEADER_CAPTURE(capture_if_range, "If-Range");
+HTTP_SERVER_REGISTER_HEADER_CAPTURE(capture_accept_encoding, "Accept-Encoding");
+
+#define ASSET_MAX_HEADERS 7
+/*
+ * Dynamic resources always answer chunked, so a body-less 304 cannot be
+ * sent and a revalidation costs a full response. The small app shell is
+ * still revalidated on every load; pinned third-party files under /vendor/
+ * are kept by the browser for a long time instead. The ETag makes If-Range
+ * resumes safe in both cases.
+ */
+#define ASSET_VENDOR_PREFIX          "/vendor/"
+#define ASSET_CACHE_CONTROL_SHELL    "no-cache"
+#define ASSET_CACHE_CONTROL_VENDOR   "max-age=" STRINGIFY(CONFIG_APP_ASSET_VENDOR_MAX_AGE_S)
+#define ASSET_FS_PATH_MAX (sizeof(FILESYSTEM_WEB_FS_PATH) + CONFIG_HTTP_SERVER_MAX_URL_LENGTH + 16)
+
+struct asset_stream {
+	atomic_ptr_t owner;
+	bool active;
+	bool from_fs;
+	const uint8_t *data;
+	struct fs_file_t file;
+	size_t pos;
+	size_t end;
+	struct http_header headers[ASSET_MAX_HEADERS];
+	char content_range[48];
+	char etag[24];
+	/* LittleFS path of the asset, per client so concurrent lookups never share it. */
+	char path[ASSET_FS_PATH_MAX];
+	/* LittleFS read buffer from the filesystem heap, held while streaming. */
+	uint8_t *buf;
+};
+
+/*
+ * Content CRCs of LittleFS assets, keyed by a CRC of the path. An entry is
+ * stale when the file size changes or MCUmgr wrote any file since it was
+ * filled. Only the HTTP server thread touches the entries.
+ */
+struct fs_etag_entry {
+	uint32_t path_crc;
+	size_t size;
+	uint32_t crc;
+	atomic_val_t generation;
+	bool valid;
+};
+
+struct content_type_entry {
+	const char *ext;
+	const char *type;
+};
+
+static const struct content_type_entry content_types[] = {
+	{ ".html", "text/html" },
+	{ ".css", "text/css" },
+	{ ".js", "text/javascript" },
+	{ ".json", "application/json" },
+	{ ".svg", "image/svg+xml" },
+	{ ".png", "image/png" },
+	{ ".ico", "image/x-icon" },
+};
+
+static struct asset_stream asset_streams[CONFIG_HTTP_SERVER_MAX_CLIENTS];
+
+static struct fs_etag_entry fs_etags[CONFIG_APP_ASSET_FS_ETAG_CACHE];
+static size_t fs_etag_next;
+static atomic_t fs_etag_generation;
+
+static struct asset_stream *stream_get(struct http_client_ctx *client)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(asset_streams); i++) {
+		if (atomic_ptr_get(&asset_streams[i].owner) == client) {
+			return &asset_streams[i];
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(asset_streams); i++) {
+		if (atomic_ptr_cas(&asset_streams[i].owner, NULL, client)) {
+			return &asset_streams[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void stream_close(struct asset_stream *stream)
+{
+	if (stream->active && stream->from_fs) {
+		(void)fs_close(&stream->file);
+	}
+
+	if (stream->buf != NULL) {
+		app_utils_heap_free(APP_HEAP_FS, stream->buf);
+		stream->buf = NULL;
+	}
+
+	stream->active = false;
+}
+
+static const char *request_header(const struct http_request_ctx *request_ctx, const char *name)
+{
+	if (request_ctx->headers_status != HTTP_HEADER_STATUS_OK) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < request_ctx->header_count; i++) {
+		if (strcasecmp(request_ctx->headers[i].name, name) == 0) {
+			return request_ctx->headers[i].value;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Parse a single "bytes=" range. Returns 1 with [start, end) set, 0 when the
+ * header should be ignored (full response), or -ERANGE if unsatisfiable.
+ */
+static int parse_range(const char *value, size_t total, size_t *start, size_t *end)
+{
+	unsigned long first;
+	unsigned long last;
+	char *next;
+
+	if ((strncmp(value, "bytes=", 6) != 0) || (strchr(value, ',') != NULL)) {
+		return 0;
+	}
+
+	value += 6;
+	if (*value == '-') {
+		last = strtoul(value + 1, &next, 10);
+		if ((next == value + 1) || (*next != '\0')) {
+			return 0;
+		}
+
+		if ((last == 0U) || (total == 0U)) {
+			return -ERANGE;
+		}
+
+		*start = (last >= total) ? 0U : (total - last);
+		*end = total;
+		return 1;
+	}
+
+	first = strtoul(value, &next, 10);
+	if ((next == value) || (*next != '-')) {
+		return 0;
+	}
+
+	value = next + 1;
+	if (*value == '\0') {
+		last = ULONG_MAX;
+	} else {
+		last = strtoul(value, &next, 10);
+		if ((next == value) || (*next != '\0') || (last < first)) {
+			return 0;
+		}
+	}
+
+	if (first >= total) {
+		return -ERANGE;
+	}
+
+	*start = first;
+	*end = (last >= total) ? total : (last + 1U);
+	return 1;
+}
+
+/* True unless Accept-Encoding is present without gzip, or with gzip;q=0. */
+static bool accepts_gzip(const char *accept_encoding)
+{
+	const char *pos;
+
+	if (accept_encoding == NULL) {
+		return true;
+	}
+
+	pos = strstr(accept_encoding, "gzip");
+	if (pos == NULL) {
+		return false;
+	}
+
+	pos += strlen("gzip");
+	pos += strspn(pos, " ");
+	if (*pos != ';') {
+		return true;
+	}
+
+	pos++;
+	pos += strspn(pos, " ");
+	if (strncmp(pos, "q=0", 3) != 0) {
+		return true;
+	}
+
+	/* q=0, q=0. and q=0.000 refuse it; q=0.5 does not. */
+	pos += 3;
+	pos += strspn(pos, ".0");
+	return (*pos != '\0') && (*pos != ',') && (*pos != ' ');
+}
+
+static const char *content_type_for(const char *path)
+{
+	const char *ext = strrchr(path, '.');
+
+	if (ext != NULL) {
+		for (size_t i = 0; i < ARRAY_SIZE(content_types); i++) {
+			if (strcmp(ext, content_types[i].ext) == 0) {
+				return content_types[i].type;
+			}
+		}
+	}
+
+	return "application/octet-stream";
+}
+
+static int open_fs_asset(struct asset_stream *stream, const char *url, bool gzip_ok,
+			 const char **content_type, const char **content_encoding, size_t *total)
+{
+	char *path = stream->path;
+	struct fs_dirent entry;
+	size_t url_len = strcspn(url, "?#");
+	size_t len;
+	int ret;
+
+	if ((url_len == 0U) || (url[0] != '/') || (strstr(url, "..") != NULL)) {
+		return -ENOENT;
+	}
+
+	len = snprintk(path, sizeof(stream->path), "%s%.*s%s", FILESYSTEM_WEB_FS_PATH,
+		       (int)url_len, url, (url[url_len - 1] == '/') ? "index.html" : "");
+	if (len >= sizeof(stream->path) - 3) {
+		return -ENAMETOOLONG;
+	}
+
+	*content_type = content_type_for(path);
+	*content_encoding = NULL;
+
+	/* Prefer a pre-compressed sibling when the client takes gzip. */
+	strcpy(&path[len], ".gz");
+	if (gzip_ok && (fs_stat(path, &entry) == 0)) {
+		*content_encoding = "gzip";
+	} else {
+		path[len] = '\0';
+		ret = fs_stat(path, &entry);
+		if (ret < 0) {
+			/* Only a gzip copy exists and the client refused it. */
+			strcpy(&path[len], ".gz");
+			return (!gzip_ok && (fs_stat(path, &entry) == 0)) ? -ENOTSUP : ret;
+		}
+	}
+
+	if (entry.type != FS_DIR_ENTRY_FILE) {
+		return -ENOENT;
+	}
+
+	fs_file_t_init(&stream->file);
+	ret = fs_open(&stream->file, path, FS_O_READ);
+	if (ret < 0) {
+		return ret;
+	}
+
+	*total = entry.size;
+	return 0;
+}
+
+/* CRC32 of the open LittleFS asset, read through the stream buffer on a cache miss. */
+static int fs_asset_crc(struct asset_stream *stream, size_t total, uint32_t *crc)
+{
+	uint32_t path_crc = crc32_ieee((const uint8_t *)stream->path, strlen(stream->path));
+	atomic_val_t generation = atomic_get(&fs_etag_generation);
+	struct fs_etag_entry *entry = NULL;
+	uint32_t sum = 0U;
+	ssize_t len;
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(fs_etags); i++) {
+		if (fs_etags[i].valid && (fs_etags[i].path_crc == path_crc)) {
+			entry = &fs_etags[i];
+			break;
+		}
+	}
+
+	if ((entry != NULL) && (entry->size == total) && (entry->generation == generation)) {
+		*crc = entry->crc;
+		return 0;
+	}
+
+	do {
+		len = fs_read(&stream->file, stream->buf, CONFIG_APP_ASSET_CHUNK_SIZE);
+		if (len < 0) {
+			return (int)len;
+		}
+		sum = crc32_ieee_update(sum, stream->buf, (size_t)len);
+	} while (len > 0);
+
+	ret = fs_seek(&stream->file, 0, FS_SEEK_SET);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (entry == NULL) {
+		entry = &fs_etags[fs_etag_next];
+		fs_etag_next = (fs_etag_next + 1U) % ARRAY_SIZE(fs_etags);
+	}
+
+	*entry = (struct fs_etag_entry){
+		.path_crc = path_crc,
+		.size = total,
+		.crc = sum,
+		.generation = generation,
+		.valid = true,
+	};
+	*crc = sum;
+	return 0;
+}
+
+static int stream_setup(struct asset_stream *stream, struct http_client_ctx *client,
+			const struct http_request_ctx *request_ctx,
+			struct http_response_ctx *response_ctx, struct asset_handler_blob *blob)
+{
+	const char *content_type = NULL;
+	const char *content_encoding;
+	const char *range;
+	const char *if_range;
+	uint32_t crc;
+	size_t header_count = 0;
+	size_t total;
+	int ret;
+
+	if (blob != NULL) {
+		if (!blob->etag_valid) {
+			blob->etag_crc = crc32_ieee(blob->data, blob->len);
+			blob->etag_valid = true;
+		}
+
+		stream->from_fs = false;
+		stream->data = blob->data;
+		content_encoding = blob->content_encoding;
+		total = blob->len;
+		crc = blob->etag_crc;
+	} else {
+		stream->from_fs = true;
+		stream->buf = app_utils_heap_alloc(APP_HEAP_FS, CONFIG_APP_ASSET_CHUNK_SIZE);
+		if (stream->buf == NULL) {
+			response_ctx->status = HTTP_503_SERVICE_UNAVAILABLE;
+			response_ctx->final_chunk = true;
+			return 0;
+		}
+
+		ret = open_fs_asset(stream, client->url_buffer,
+				    accepts_gzip(request_header(request_ctx, "Accept-Encoding")),
+				    &content_type, &content_encoding, &total);
+		if (ret < 0) {
+			app_utils_heap_free(APP_HEAP_FS, stream->buf);
+			stream->buf = NULL;
+			response_ctx->status =
+				(ret == -ENOTSUP) ? HTTP_406_NOT_ACCEPTABLE : HTTP_404_NOT_FOUND;
+			response_ctx->final_chunk = true;
+			return 0;
+		}
+
+		/* From here on stream_close() also closes the file. */
+		stream->active = true;
+		ret = fs_asset_crc(stream, total, &crc);
+		if (ret < 0) {
+			LOG_ERR("Asset read failed (%d)", ret);
+			stream_close(stream);
+			return ret;
+		}
+	}
+
+	snprintk(stream->etag, sizeof(stream->etag), "\"%08x\"", crc);
+	stream->active = true;
+	stream->pos = 0U;
+	stream->end = total;
+	response_ctx->status = HTTP_200_OK;
+
+	range = request_header(request_ctx, "Range");
+	if_range = request_header(request_ctx, "If-Range");
+	if ((range != NULL) && (if_range != NULL) && (strcmp(if_range, stream->etag) != 0)) {
+		range = NULL;
+	}
+
+	ret = (range != NULL) ? parse_range(range, total, &stream->pos, &stream->end) : 0;
+	if (ret == -ERANGE) {
+		snprintk(stream->content_range, sizeof(stream->content_range), "bytes */%zu",
+			 total);
+		stream->pos = stream->end = 0U;
+		response_ctx->status = HTTP_416_RANGE_NOT_SATISFIABLE;
+	} else if (ret == 1) {
+		snprintk(stream->content_range, sizeof(stream->content_range), "bytes %zu-%zu/%zu",
+			 stream->pos, stream->end - 1U, total);
+		response_ctx->status = HTTP_206_PARTIAL_CONTENT;
+	} else {
+		stream->content_range[0] = '\0';
+	}
+
+	stream->headers[header_count++] = (struct http_header){ "Accept-Ranges", "bytes" };
+	if (content_type != NULL) {
+		stream->headers[header_count++] =
+			(struct http_header){ "Content-Type", content_type };
+	}
+	if (content_encoding != NULL) {
+		stream->headers[header_count++] =
+			(struct http_header){ "Content-Encoding", content_encoding };
+	}
+	if (stream->from_fs) {
+		/* The .gz sibling is picked by Accept-Encoding. */
+		stream->headers[header_count++] =
+			(struct http_header){ "Vary", "Accept-Encoding" };
+	}
+	stream->headers[header_count++] = (struct http_header){ "ETag", stream->etag };
+	stream->headers[header_count++] = (struct http_header){
+		"Cache-Control", (strncmp(client->url_buffer, ASSET_VENDOR_PREFIX,
+					  sizeof(ASSET_VENDOR_PREFIX) - 1) == 0)
+					 ? ASSET_CACHE_CONTROL_VENDOR
+					 : ASSET_CACHE_CONTROL_SHELL
+	};
+	if (stream->content_range[0] != '\0') {
+		stream->headers[header_count++] =
+			(struct http_header){ "Content-Range", stream->content_range };
+	}
+
+	if (stream->from_fs && (stream->pos > 0U)) {
+		ret = fs_seek(&stream->file, (off_t)stream->pos, FS_SEEK_SET);
+		if (ret < 0) {
+			stream_close(stream);
+			return ret;
+		}
+	}
+
+	response_ctx->headers = stream->headers;
+	response_ctx->header_count = header_count;
+	return 0;
+}
+
+int asset_handler_cb(struct http_client_ctx *client, enum http_data_status status,
+		     const struct http_request_ctx *request_ctx,
+		     struct http_response_ctx *response_ctx, void *user_data)
+{
+	struct asset_stream *stream;
+	ssize_t len;
+	int ret;
+
+	stream = stream_get(client);
+	if (stream == NULL) {
+		LOG_WRN("No asset stream for client %p", (void *)client);
+		return -ENOMEM;
+	}
+
+	if (status == HTTP_SERVER_DATA_ABORTED) {
+		stream_close(stream);
+		return 0;
+	}
+
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+
+	if (!stream->active) {
+		ret = stream_setup(stream, client, request_ctx, response_ctx, user_data);
+		if ((ret < 0) || !stream->active) {
+			return ret;
+		}
+	}
+
+	len = (ssize_t)MIN(stream->end - stream->pos, CONFIG_APP_ASSET_CHUNK_SIZE);
+	if (!stream->from_fs) {
+		/* Embedded assets are sent in place without copying. */
+		len = (ssize_t)(stream->end - stream->pos);
+		response_ctx->body = &stream->data[stream->pos];
+	} else if (len > 0) {
+		len = fs_read(&stream->file, stream->buf, (size_t)len);
+		if (len <= 0) {
+			LOG_ERR("Asset read failed (%d)", (int)len);
+			stream_close(stream);
+			return (len < 0) ? (int)len : -EIO;
+		}
+		response_ctx->body = stream->buf;
+	}
+
+	stream->pos += (size_t)len;
+	response_ctx->body_len = (size_t)len;
+	response_ctx->final_chunk = (stream->pos >= stream->end);
+	if (response_ctx->final_chunk) {
+		stream_close(stream);
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_MCUMGR_GRP_FS_FILE_ACCESS_HOOK)
+/* Runs on the MCUmgr work queue, so it only bumps the generation. */
+static enum mgmt_cb_return fs_write_hook(uint32_t event, enum mgmt_cb_return prev_status,
+					 int32_t *rc, uint16_t *group, bool *abort_more,
+					 void *data, size_t data_size)
+{
+	const struct fs_mgmt_file_access *access = data;
+
+	ARG_UNUSED(event);
+	ARG_UNUSED(prev_status);
+	ARG_UNUSED(rc);
+	ARG_UNUSED(group);
+	ARG_UNUSED(abort_more);
+	ARG_UNUSED(data_size);
+
+	if (access->access == FS_MGMT_FILE_ACCESS_WRITE) {
+		(void)atomic_inc(&fs_etag_generation);
+	}
+
+	return MGMT_CB_OK;
+}
+
+static struct mgmt_callback fs_write_callback = {
+	.callback = fs_write_hook,
+	.event_id = MGMT_EVT_OP_FS_MGMT_FILE_ACCESS,
+};
+#endif
+
+void asset_handler_init(void)
+{
+#if defined(CONFIG_MCUMGR_GRP_FS_FILE_ACCESS_HOOK)
+	mgmt_callback_register(&fs_write_callback);
+#endif
+}
@@ -0,0 +1,32 @@
+#ifndef ASSET_HANDLER_H
+#define ASSET_HANDLER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/net/http/server.h>
+
+/* Asset embedded in the firmware image, passed as dynamic resource user_data. */
+struct asset_handler_blob {
+	const uint8_t *data;
+	size_t len;
+	const char *content_encoding;
+	uint32_t etag_crc;
+	bool etag_valid;
+};
+
+/*
+ * Dynamic resource callback serving GET with single-range
+ * "Range: bytes=..." support and a content CRC as ETag. With a blob as
+ * user_data it serves that blob, with NULL user_data it maps the request
+ * URL onto FILESYSTEM_WEB_FS_PATH.
+ */
+int asset_handler_cb(struct http_client_ctx *client, enum http_data_status status,
+		     const struct http_request_ctx *request_ctx,
+		     struct http_response_ctx *response_ctx, void *user_data);
+
+/* Drop cached LittleFS ETags whenever MCUmgr writes a file, if hooks are enabled. */
+void asset_handler_init(void);
+
+#endif
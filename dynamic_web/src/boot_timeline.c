@@ -0,0 +1,128 @@
+#include "boot_timeline.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(boot_timeline, LOG_LEVEL_INF);
+
+#define BOOT_TIMELINE_JSON_MAX 640
+
+struct boot_phase_span {
+	uint64_t start;
+	uint64_t end;
+};
+
+static const char *const phase_names[BOOT_PHASE_COUNT] = {
+	[BOOT_PHASE_KERNEL] = "kernel",
+	[BOOT_PHASE_WIFI_ASSOC] = "wifi_assoc",
+	[BOOT_PHASE_DHCP] = "dhcp",
+	[BOOT_PHASE_FS_MOUNT] = "fs_mount",
+	[BOOT_PHASE_ASSET_SYNC] = "asset_sync",
+	[BOOT_PHASE_METRICS_ARCHIVE] = "metrics_archive",
+	[BOOT_PHASE_HTTP_START] = "http_start",
+};
+
+/* Written by main() during boot only, read after boot_timeline_ready(). */
+static struct boot_phase_span phases[BOOT_PHASE_COUNT];
+static uint64_t ready_cycles;
+static char timeline_json[BOOT_TIMELINE_JSON_MAX];
+static size_t timeline_json_len;
+static atomic_t timeline_frozen;
+static atomic_t timeline_published;
+
+uint64_t boot_timeline_now(void)
+{
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+	return k_cycle_get_64();
+#else
+	/* A 32-bit counter wraps within seconds at CPU clock; use tick resolution. */
+	return k_ticks_to_cyc_floor64(k_uptime_ticks());
+#endif
+}
+
+static uint64_t cycles_to_us(uint64_t cycles)
+{
+	return k_cyc_to_us_floor64(cycles);
+}
+
+void boot_timeline_main_entry(void)
+{
+	phases[BOOT_PHASE_KERNEL].start = 0U;
+	phases[BOOT_PHASE_KERNEL].end = boot_timeline_now();
+}
+
+void boot_timeline_begin(enum boot_phase phase)
+{
+	if (atomic_get(&timeline_frozen) == 0) {
+		phases[phase].start = boot_timeline_now();
+		phases[phase].end = 0U;
+	}
+}
+
+void boot_timeline_end(enum boot_phase phase)
+{
+	if ((atomic_get(&timeline_frozen) == 0) && (phases[phase].start != 0U)) {
+		phases[phase].end = boot_timeline_now();
+	}
+}
+
+static bool phase_recorded(enum boot_phase phase)
+{
+	return phases[phase].end > phases[phase].start;
+}
+
+void boot_timeline_ready(void)
+{
+	size_t len;
+	bool first = true;
+
+	if (atomic_set(&timeline_frozen, 1) != 0) {
+		return;
+	}
+
+	ready_cycles = boot_timeline_now();
+	len = snprintk(timeline_json, sizeof(timeline_json),
+		       "{\"cycles_per_sec\":%u,\"ready_us\":%llu,\"phases\":{",
+		       (unsigned int)sys_clock_hw_cycles_per_sec(), cycles_to_us(ready_cycles));
+
+	LOG_INF("Boot timeline (ready after %llu us):", cycles_to_us(ready_cycles));
+	for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+		uint64_t cycles = phases[i].end - phases[i].start;
+
+		if (!phase_recorded(i)) {
+			continue;
+		}
+
+		LOG_INF("  %-16s start %10llu us  took %10llu us", phase_names[i],
+			cycles_to_us(phases[i].start), cycles_to_us(cycles));
+
+		if (len < sizeof(timeline_json)) {
+			len += snprintk(&timeline_json[len], sizeof(timeline_json) - len,
+					"%s\"%s\":{\"start_us\":%llu,\"us\":%llu,\"cycles\":%llu}",
+					first ? "" : ",", phase_names[i],
+					cycles_to_us(phases[i].start), cycles_to_us(cycles), cycles);
+		}
+		first = false;
+	}
+
+	if (len < sizeof(timeline_json)) {
+		len += snprintk(&timeline_json[len], sizeof(timeline_json) - len, "}}");
+	}
+
+	timeline_json_len = MIN(len, sizeof(timeline_json) - 1);
+	atomic_set(&timeline_published, 1);
+}
+
+const char *boot_timeline_json(size_t *len)
+{
+	if (atomic_get(&timeline_published) == 0) {
+		return NULL;
+	}
+
+	*len = timeline_json_len;
+	return timeline_json;
+}
@@ -0,0 +1,35 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum boot_phase {
+	/* Reset until main() runs; ends in boot_timeline_main_entry(). */
+	BOOT_PHASE_KERNEL,
+	BOOT_PHASE_WIFI_ASSOC,
+	BOOT_PHASE_DHCP,
+	BOOT_PHASE_FS_MOUNT,
+	BOOT_PHASE_ASSET_SYNC,
+	BOOT_PHASE_METRICS_ARCHIVE,
+	BOOT_PHASE_HTTP_START,
+	BOOT_PHASE_COUNT,
+};
+
+/*
+ * Hardware cycles since reset, 64-bit so spans never wrap. Falls back to
+ * tick resolution when the timer has no 64-bit cycle counter.
+ */
+uint64_t boot_timeline_now(void);
+
+void boot_timeline_main_entry(void);
+void boot_timeline_begin(enum boot_phase phase);
+void boot_timeline_end(enum boot_phase phase);
+
+/* Freeze the timeline, log it once and render the /api/boot body. */
+void boot_timeline_ready(void);
+
+/* JSON body for /api/boot, or NULL until boot_timeline_ready(). */
+const char *boot_timeline_json(size_t *len);
+
+#endif
@@ -0,0 +1,245 @@
+#include "filesystem_bench.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+
+#include "boot_timeline.h"
+#include "filesystem_service.h"
+
+LOG_MODULE_REGISTER(filesystem_bench, LOG_LEVEL_INF);
+
+#define BENCH_MOUNT_POINT "/bench"
+#define BENCH_FILE_PATH   BENCH_MOUNT_POINT "/data.bin"
+#define BENCH_CHUNK_SIZE  512
+#define BENCH_RANDOM_SIZE 256
+/* Leave room for metadata blocks on small partitions such as native_sim's. */
+#define BENCH_FILE_SIZE                                                                        \
+	MIN(CONFIG_APP_FS_BENCHMARK_FILE_SIZE, FIXED_PARTITION_SIZE(storage_partition) / 4)
+
+BUILD_ASSERT((BENCH_FILE_SIZE % BENCH_CHUNK_SIZE) == 0,
+	     "Benchmark file size must be a multiple of the chunk size");
+
+FS_LITTLEFS_DECLARE_CUSTOM_CONFIG(bench_default, 4, 16, 16, 64, 32);
+FS_LITTLEFS_DECLARE_CUSTOM_CONFIG(bench_storage, 4, FILESYSTEM_STORAGE_READ_SIZE,
+				  FILESYSTEM_STORAGE_PROG_SIZE, FILESYSTEM_STORAGE_CACHE_SIZE,
+				  FILESYSTEM_STORAGE_LOOKAHEAD_SIZE);
+FS_LITTLEFS_DECLARE_CUSTOM_CONFIG(bench_c512, 4, 16, 16, 512, 128);
+FS_LITTLEFS_DECLARE_CUSTOM_CONFIG(bench_c1024, 4, 64, 64, 1024, 256);
+
+struct bench_profile {
+	const char *name;
+	struct fs_littlefs *cfg;
+};
+
+static const struct bench_profile bench_profiles[] = {
+	{ "kconfig-default", &bench_default },
+	{ "storage", &bench_storage },
+	{ "cache512", &bench_c512 },
+	{ "cache1024", &bench_c1024 },
+};
+
+static struct fs_mount_t bench_mount = {
+	.type = FS_LITTLEFS,
+	.mnt_point = BENCH_MOUNT_POINT,
+	.storage_dev = (void *)FIXED_PARTITION_ID(storage_partition),
+};
+
+static uint8_t bench_buf[BENCH_CHUNK_SIZE];
+static uint32_t bench_rand_state;
+
+struct bench_result {
+	uint32_t format_us;
+	uint32_t mount_us;
+	uint32_t seq_write_kib_s;
+	uint32_t seq_read_kib_s;
+	uint32_t rand_write_ops_s;
+	uint32_t rand_read_ops_s;
+};
+
+/* Same offsets for every profile, so results are comparable between runs. */
+static uint32_t bench_rand(void)
+{
+	bench_rand_state ^= bench_rand_state << 13;
+	bench_rand_state ^= bench_rand_state >> 17;
+	bench_rand_state ^= bench_rand_state << 5;
+	return bench_rand_state;
+}
+
+static uint32_t elapsed_us(uint64_t start_cycles)
+{
+	return (uint32_t)MAX(k_cyc_to_us_floor64(boot_timeline_now() - start_cycles), 1U);
+}
+
+static int bench_sequential(struct bench_result *result)
+{
+	struct fs_file_t file;
+	uint64_t start;
+	ssize_t len;
+	int ret;
+
+	fs_file_t_init(&file);
+	ret = fs_open(&file, BENCH_FILE_PATH, FS_O_CREATE | FS_O_RDWR | FS_O_TRUNC);
+	if (ret < 0) {
+		return ret;
+	}
+
+	start = boot_timeline_now();
+	for (size_t pos = 0; pos < BENCH_FILE_SIZE; pos += sizeof(bench_buf)) {
+		memset(bench_buf, (int)(pos / sizeof(bench_buf)), sizeof(bench_buf));
+		len = fs_write(&file, bench_buf, sizeof(bench_buf));
+		if (len != sizeof(bench_buf)) {
+			(void)fs_close(&file);
+			return (len < 0) ? (int)len : -ENOSPC;
+		}
+	}
+
+	ret = fs_sync(&file);
+	result->seq_write_kib_s = (uint32_t)((uint64_t)BENCH_FILE_SIZE * USEC_PER_SEC / 1024U /
+					     elapsed_us(start));
+	if (ret == 0) {
+		ret = fs_seek(&file, 0, FS_SEEK_SET);
+	}
+
+	start = boot_timeline_now();
+	for (size_t pos = 0; (ret == 0) && (pos < BENCH_FILE_SIZE); pos += sizeof(bench_buf)) {
+		len = fs_read(&file, bench_buf, sizeof(bench_buf));
+		if (len != sizeof(bench_buf)) {
+			ret = (len < 0) ? (int)len : -EIO;
+		}
+	}
+
+	result->seq_read_kib_s = (uint32_t)((uint64_t)BENCH_FILE_SIZE * USEC_PER_SEC / 1024U /
+					    elapsed_us(start));
+	(void)fs_close(&file);
+	return ret;
+}
+
+static int bench_random(struct bench_result *result, bool write)
+{
+	struct fs_file_t file;
+	uint64_t start;
+	uint32_t ops_s;
+	off_t offset;
+	ssize_t len;
+	int ret;
+
+	fs_file_t_init(&file);
+	ret = fs_open(&file, BENCH_FILE_PATH, write ? FS_O_RDWR : FS_O_READ);
+	if (ret < 0) {
+		return ret;
+	}
+
+	bench_rand_state = 0x2545f491U;
+	start = boot_timeline_now();
+	for (int i = 0; (ret == 0) && (i < CONFIG_APP_FS_BENCHMARK_RANDOM_OPS); i++) {
+		offset = (off_t)((bench_rand() % (BENCH_FILE_SIZE / BENCH_RANDOM_SIZE)) *
+				 BENCH_RANDOM_SIZE);
+		ret = fs_seek(&file, offset, FS_SEEK_SET);
+		if (ret < 0) {
+			break;
+		}
+
+		len = write ? fs_write(&file, bench_buf, BENCH_RANDOM_SIZE)
+			    : fs_read(&file, bench_buf, BENCH_RANDOM_SIZE);
+		if (len != BENCH_RANDOM_SIZE) {
+			ret = (len < 0) ? (int)len : -EIO;
+		}
+	}
+
+	if ((ret == 0) && write) {
+		ret = fs_sync(&file);
+	}
+
+	ops_s = (uint32_t)((uint64_t)CONFIG_APP_FS_BENCHMARK_RANDOM_OPS * USEC_PER_SEC /
+			   elapsed_us(start));
+	if (write) {
+		result->rand_write_ops_s = ops_s;
+	} else {
+		result->rand_read_ops_s = ops_s;
+	}
+	(void)fs_close(&file);
+	return ret;
+}
+
+static int bench_profile_run(const struct bench_profile *profile, struct bench_result *result)
+{
+	uint64_t start;
+	int ret;
+
+	bench_mount.fs_data = profile->cfg;
+
+	start = boot_timeline_now();
+	ret = fs_mkfs(FS_LITTLEFS, (uintptr_t)bench_mount.storage_dev, profile->cfg, 0);
+	result->format_us = elapsed_us(start);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = fs_mount(&bench_mount);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = bench_sequential(result);
+	if (ret == 0) {
+		ret = bench_random(result, true);
+	}
+	if (ret == 0) {
+		ret = bench_random(result, false);
+	}
+
+	/* Time a mount of a populated filesystem, as seen at boot. */
+	(void)fs_unmount(&bench_mount);
+	if (ret == 0) {
+		start = boot_timeline_now();
+		ret = fs_mount(&bench_mount);
+		result->mount_us = elapsed_us(start);
+		if (ret == 0) {
+			(void)fs_unmount(&bench_mount);
+		}
+	}
+
+	return ret;
+}
+
+int filesystem_bench_run(void)
+{
+	struct bench_result result;
+	int failures = 0;
+	int ret;
+
+	LOG_INF("LittleFS benchmark on storage_partition (%u bytes), file %u bytes, %u random ops",
+		(unsigned int)FIXED_PARTITION_SIZE(storage_partition),
+		(unsigned int)BENCH_FILE_SIZE, CONFIG_APP_FS_BENCHMARK_RANDOM_OPS);
+	LOG_INF("%-16s %5s %5s %5s %5s %10s %10s %10s %10s %9s %9s", "profile", "read", "prog",
+		"cache", "look", "seq_wr", "seq_rd", "rnd_wr", "rnd_rd", "mount", "format");
+
+	for (size_t i = 0; i < ARRAY_SIZE(bench_profiles); i++) {
+		const struct bench_profile *profile = &bench_profiles[i];
+		const struct lfs_config *cfg = &profile->cfg->cfg;
+
+		memset(&result, 0, sizeof(result));
+		ret = bench_profile_run(profile, &result);
+		if (ret < 0) {
+			LOG_ERR("Profile %s failed (%d)", profile->name, ret);
+			failures++;
+			continue;
+		}
+
+		LOG_INF("%-16s %5u %5u %5u %5u %6uKiB/s %6uKiB/s %7uop/s %7uop/s %7uus %7uus",
+			profile->name, (unsigned int)cfg->read_size, (unsigned int)cfg->prog_size,
+			(unsigned int)cfg->cache_size, (unsigned int)cfg->lookahead_size,
+			result.seq_write_kib_s, result.seq_read_kib_s, result.rand_write_ops_s,
+			result.rand_read_ops_s, result.mount_us, result.format_us);
+	}
+
+	LOG_INF("Benchmark done; storage_partition was erased");
+	return (failures == 0) ? 0 : -EIO;
+}
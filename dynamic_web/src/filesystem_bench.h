@@ -0,0 +1,10 @@
+#ifndef FILESYSTEM_BENCH_H
+#define FILESYSTEM_BENCH_H
+
+/*
+ * Format storage_partition with each LittleFS profile in turn and log
+ * sequential/random throughput and mount time. Erases the partition.
+ */
+int filesystem_bench_run(void);
+
+#endif
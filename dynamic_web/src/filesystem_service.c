@@ -4,13 +4,18 @@
 
 #include <zephyr/fs/fs.h>
 #include <zephyr/fs/littlefs.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/storage/flash_map.h>
 #include <zephyr/sys/util.h>
 
+#include "boot_timeline.h"
+
 LOG_MODULE_REGISTER(filesystem_service, LOG_LEVEL_INF);
 
-FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+FS_LITTLEFS_DECLARE_CUSTOM_CONFIG(storage, 4, FILESYSTEM_STORAGE_READ_SIZE,
+				  FILESYSTEM_STORAGE_PROG_SIZE, FILESYSTEM_STORAGE_CACHE_SIZE,
+				  FILESYSTEM_STORAGE_LOOKAHEAD_SIZE);
 
 static struct fs_mount_t web_fs_mount = {
 	.type = FS_LITTLEFS,
@@ -19,6 +24,8 @@ static struct fs_mount_t web_fs_mount = {
 	.fs_data = &storage,
 };
 
+static struct filesystem_service_timing fs_timing;
+
 static const uint8_t web_index_html[] = {
 #include "web_index_html.inc"
 };
@@ -31,6 +38,10 @@ static const uint8_t web_app_js[] = {
 #include "web_app_js.inc"
 };
 
+static const uint8_t web_sw_js[] = {
+#include "web_sw_js.inc"
+};
+
 static const uint8_t web_bootstrap_min_css_gz[] = {
 #include "web_bootstrap_min_css_gz.inc"
 };
@@ -49,6 +60,7 @@ static const struct web_asset web_assets[] = {
 	{ FILESYSTEM_WEB_FS_PATH "/index.html", web_index_html, sizeof(web_index_html) },
 	{ FILESYSTEM_WEB_FS_PATH "/styles.css", web_styles_css, sizeof(web_styles_css) },
 	{ FILESYSTEM_WEB_FS_PATH "/app.js", web_app_js, sizeof(web_app_js) },
+	{ FILESYSTEM_WEB_FS_PATH "/sw.js", web_sw_js, sizeof(web_sw_js) },
 	{ FILESYSTEM_WEB_FS_PATH "/vendor/bootstrap/css/bootstrap.min.css.gz", web_bootstrap_min_css_gz,
 	  sizeof(web_bootstrap_min_css_gz) },
 	{ FILESYSTEM_WEB_FS_PATH "/vendor/bootstrap/js/bootstrap.bundle.min.js.gz",
@@ -92,6 +104,21 @@ static int write_asset_to_fs(const struct web_asset *asset)
 	return 0;
 }
 
+static uint32_t elapsed_us(uint64_t start_cycles)
+{
+	return (uint32_t)k_cyc_to_us_floor64(boot_timeline_now() - start_cycles);
+}
+
+/* Flag boot-time I/O that got slower than its budget. */
+static void check_budget(const char *what, uint32_t us, uint32_t budget_ms)
+{
+	if ((budget_ms > 0U) && (us > budget_ms * USEC_PER_MSEC)) {
+		LOG_WRN("%s took %u ms, budget is %u ms", what, us / USEC_PER_MSEC, budget_ms);
+	} else {
+		LOG_INF("%s took %u us", what, us);
+	}
+}
+
 static int ensure_directory(const char *path)
 {
 	struct fs_dirent entry;
@@ -115,7 +142,7 @@ static int ensure_directory(const char *path)
 	return 0;
 }
 
-int filesystem_service_mount_or_format(void)
+static int mount_or_format(void)
 {
 	int ret;
 
@@ -126,6 +153,7 @@ int filesystem_service_mount_or_format(void)
 	}
 
 	LOG_WRN("Mount failed (%d), formatting storage partition", ret);
+	fs_timing.formatted = true;
 	ret = fs_mkfs(FS_LITTLEFS, (uintptr_t)web_fs_mount.storage_dev, web_fs_mount.fs_data, 0);
 	if (ret < 0) {
 		LOG_ERR("LittleFS format failed (%d)", ret);
@@ -142,7 +170,31 @@ int filesystem_service_mount_or_format(void)
 	return 0;
 }
 
-int filesystem_service_sync_web_assets(void)
+int filesystem_service_mount_or_format(void)
+{
+	uint64_t start = boot_timeline_now();
+	int ret;
+
+	fs_timing.formatted = false;
+	boot_timeline_begin(BOOT_PHASE_FS_MOUNT);
+	ret = mount_or_format();
+	boot_timeline_end(BOOT_PHASE_FS_MOUNT);
+	fs_timing.mount_us = elapsed_us(start);
+	if (ret == 0) {
+		check_budget(fs_timing.formatted ? "Format and mount" : "Mount",
+			     fs_timing.mount_us,
+			     fs_timing.formatted ? 0U : CONFIG_APP_FS_MOUNT_BUDGET_MS);
+	}
+
+	return ret;
+}
+
+int filesystem_service_unmount(void)
+{
+	return fs_unmount(&web_fs_mount);
+}
+
+static int sync_web_assets(void)
 {
 	int ret;
 
@@ -186,3 +238,24 @@ int filesystem_service_sync_web_assets(void)
 	LOG_INF("Web assets synced to %s", FILESYSTEM_WEB_FS_PATH);
 	return 0;
 }
+
+int filesystem_service_sync_web_assets(void)
+{
+	uint64_t start = boot_timeline_now();
+	int ret;
+
+	boot_timeline_begin(BOOT_PHASE_ASSET_SYNC);
+	ret = sync_web_assets();
+	boot_timeline_end(BOOT_PHASE_ASSET_SYNC);
+	fs_timing.sync_us = elapsed_us(start);
+	if ((ret == 0) && IS_ENABLED(CONFIG_APP_SYNC_WEB_FILES_ON_BOOT)) {
+		check_budget("Web asset sync", fs_timing.sync_us, CONFIG_APP_FS_SYNC_BUDGET_MS);
+	}
+
+	return ret;
+}
+
+void filesystem_service_get_timing(struct filesystem_service_timing *timing)
+{
+	*timing = fs_timing;
+}
@@ -4,7 +4,30 @@
 #define FILESYSTEM_WEB_MOUNT_POINT "/lfs"
 #define FILESYSTEM_WEB_FS_PATH     FILESYSTEM_WEB_MOUNT_POINT "/www"
 
+/*
+ * LittleFS profile for storage_partition (4 KiB erase sectors, 256 byte
+ * program pages). Compare against other profiles with CONFIG_APP_FS_BENCHMARK.
+ */
+#define FILESYSTEM_STORAGE_READ_SIZE      16
+#define FILESYSTEM_STORAGE_PROG_SIZE      16
+#define FILESYSTEM_STORAGE_CACHE_SIZE     256
+#define FILESYSTEM_STORAGE_LOOKAHEAD_SIZE 64
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct filesystem_service_timing {
+	/* Total time of the last filesystem_service_mount_or_format(), format included. */
+	uint32_t mount_us;
+	uint32_t sync_us;
+	/* The last mount had to format the partition first. */
+	bool formatted;
+};
+
 int filesystem_service_mount_or_format(void);
+int filesystem_service_unmount(void);
 int filesystem_service_sync_web_assets(void);
+/* Durations measured by the last mount and sync, compared against the budgets. */
+void filesystem_service_get_timing(struct filesystem_service_timing *timing);
 
 #endif
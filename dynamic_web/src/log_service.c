@@ -0,0 +1,130 @@
+#include "log_service.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_output.h>
+#include <zephyr/sys/util.h>
+
+#define LOG_RING_FLAGS (LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP | \
+			LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP)
+
+/*
+ * Formatted log text is copied into a byte ring. Positions are free-running
+ * byte counters, so each reader keeps its own cursor and can tell when the
+ * writer has overtaken it.
+ */
+static uint8_t log_ring[CONFIG_APP_LOG_RING_SIZE];
+static uint32_t log_written;
+static struct k_spinlock log_ring_lock;
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_APP_LOG_RING_SIZE),
+	     "Log ring size must divide the 32-bit cursor range");
+
+static uint8_t log_output_buf[128];
+
+static int log_ring_out(uint8_t *data, size_t length, void *ctx)
+{
+	k_spinlock_key_t key;
+	size_t offset;
+	size_t first;
+
+	ARG_UNUSED(ctx);
+
+	if (length > sizeof(log_ring)) {
+		data += length - sizeof(log_ring);
+		length = sizeof(log_ring);
+	}
+
+	key = k_spin_lock(&log_ring_lock);
+	offset = log_written % sizeof(log_ring);
+	first = MIN(length, sizeof(log_ring) - offset);
+	memcpy(&log_ring[offset], data, first);
+	memcpy(log_ring, &data[first], length - first);
+	log_written += (uint32_t)length;
+	k_spin_unlock(&log_ring_lock, key);
+
+	return (int)length;
+}
+
+LOG_OUTPUT_DEFINE(log_ring_output, log_ring_out, log_output_buf, sizeof(log_output_buf));
+
+static void log_ring_process(const struct log_backend *const backend, union log_msg_generic *msg)
+{
+	ARG_UNUSED(backend);
+
+	log_output_msg_process(&log_ring_output, &msg->log, LOG_RING_FLAGS);
+}
+
+static void log_ring_panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+
+	log_output_flush(&log_ring_output);
+}
+
+static void log_ring_dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+
+	log_output_dropped_process(&log_ring_output, cnt);
+}
+
+static const struct log_backend_api log_ring_backend_api = {
+	.process = log_ring_process,
+	.panic = log_ring_panic,
+	.dropped = log_ring_dropped,
+};
+
+LOG_BACKEND_DEFINE(log_ring_backend, log_ring_backend_api, true);
+
+/* Caller holds log_ring_lock. */
+static uint32_t log_ring_oldest(void)
+{
+	return (log_written > sizeof(log_ring)) ? (log_written - sizeof(log_ring)) : 0U;
+}
+
+uint32_t log_service_oldest_cursor(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&log_ring_lock);
+	uint32_t oldest = log_ring_oldest();
+
+	k_spin_unlock(&log_ring_lock, key);
+	return oldest;
+}
+
+uint32_t log_service_write_cursor(void)
+{
+	return *(volatile uint32_t *)&log_written;
+}
+
+size_t log_service_read(uint32_t *cursor, uint32_t end, uint8_t *buf, size_t buf_len)
+{
+	k_spinlock_key_t key = k_spin_lock(&log_ring_lock);
+	size_t offset;
+	size_t first;
+	size_t len;
+
+	/* Skip ahead if the writer lapped this reader, or the cursor is bogus. */
+	if ((log_written - *cursor) > (log_written - log_ring_oldest())) {
+		*cursor = log_ring_oldest();
+	}
+
+	/* The skip may have carried the cursor past the requested end. */
+	if ((int32_t)(end - *cursor) <= 0) {
+		k_spin_unlock(&log_ring_lock, key);
+		return 0;
+	}
+
+	len = MIN((size_t)(end - *cursor), buf_len);
+	offset = *cursor % sizeof(log_ring);
+	first = MIN(len, sizeof(log_ring) - offset);
+	memcpy(buf, &log_ring[offset], first);
+	memcpy(&buf[first], log_ring, len - first);
+	*cursor += (uint32_t)len;
+
+	k_spin_unlock(&log_ring_lock, key);
+	return len;
+}
@@ -0,0 +1,19 @@
+#ifndef LOG_SERVICE_H
+#define LOG_SERVICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Cursor of the oldest byte still held in the log ring. */
+uint32_t log_service_oldest_cursor(void);
+/* Cursor one past the newest byte written so far. */
+uint32_t log_service_write_cursor(void);
+/*
+ * Copy text from *cursor up to end and advance *cursor. A cursor the writer
+ * has lapped, or one that is not in the ring at all, restarts at the oldest
+ * byte still held.
+ */
+size_t log_service_read(uint32_t *cursor, uint32_t end, uint8_t *buf, size_t buf_len);
+
+#endif
@@ -3,7 +3,10 @@
 #include <zephyr/net/net_ip.h>
 
 #include "app_utils.h"
+#include "boot_timeline.h"
+#include "filesystem_bench.h"
 #include "filesystem_service.h"
+#include "metrics_archive.h"
 #include "webserver_service.h"
 #include "wifi_service.h"
 
@@ -23,6 +26,23 @@ int main(void)
 		.get_cpu_util_percent = app_utils_get_cpu_util_percent,
 		.get_ram_util_percent = app_utils_get_ram_util_percent,
 	};
+#if defined(CONFIG_APP_METRICS_ARCHIVE)
+	struct metrics_archive_provider archive_provider = {
+		.get_cpu_util_percent = app_utils_get_cpu_util_percent,
+		.get_ram_util_percent = app_utils_get_ram_util_percent,
+		.get_rssi = wifi_service_get_rssi,
+		.get_reconnect_count = wifi_service_get_reconnect_count,
+	};
+#endif
+
+	boot_timeline_main_entry();
+
+#if defined(CONFIG_APP_FS_BENCHMARK)
+	ret = filesystem_bench_run();
+	LOG_INF("Filesystem benchmark %s, not starting the web server",
+		(ret == 0) ? "finished" : "failed");
+	return 0;
+#endif
 
 	ret = wifi_service_init_and_connect();
 	if (ret < 0) {
@@ -41,6 +61,17 @@ int main(void)
 	}
 #endif
 
+#if defined(CONFIG_APP_METRICS_ARCHIVE)
+	/* The archive is diagnostics only; keep serving without it. */
+	boot_timeline_begin(BOOT_PHASE_METRICS_ARCHIVE);
+	ret = metrics_archive_init(&archive_provider);
+	if (ret == 0) {
+		metrics_archive_start();
+	}
+	boot_timeline_end(BOOT_PHASE_METRICS_ARCHIVE);
+#endif
+
+	boot_timeline_begin(BOOT_PHASE_HTTP_START);
 	ret = webserver_service_init(&provider);
 	if (ret < 0) {
 		LOG_ERR("Failed to init webserver service (%d)", ret);
@@ -53,6 +84,9 @@ int main(void)
 		return 0;
 	}
 
+	boot_timeline_end(BOOT_PHASE_HTTP_START);
+	boot_timeline_ready();
+
 	(void)wifi_service_get_ipv4_addr(ip, sizeof(ip));
 	LOG_INF("HTTP server running at: http://%s/", ip);
 
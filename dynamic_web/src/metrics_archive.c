@@ -0,0 +1,317 @@
+#include "metrics_archive.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#include "app_utils.h"
+#include "filesystem_service.h"
+
+LOG_MODULE_REGISTER(metrics_archive, LOG_LEVEL_INF);
+
+#define ARCHIVE_PATH      FILESYSTEM_WEB_MOUNT_POINT "/metrics.bin"
+#define PAGE_SIZE         CONFIG_APP_METRICS_ARCHIVE_PAGE_SIZE
+#define RECORDS_PER_PAGE  (PAGE_SIZE / sizeof(struct metrics_record))
+#define ARCHIVE_PAGES     CONFIG_APP_METRICS_ARCHIVE_PAGES
+#define ARCHIVE_RECORDS   (RECORDS_PER_PAGE * ARCHIVE_PAGES)
+#define ARCHIVE_SIZE      (PAGE_SIZE * ARCHIVE_PAGES)
+
+BUILD_ASSERT(sizeof(struct metrics_record) == 16, "Unexpected metrics record size");
+BUILD_ASSERT((PAGE_SIZE % sizeof(struct metrics_record)) == 0,
+	     "Archive page size must hold whole records");
+
+static void metrics_archive_thread_fn(void *p1, void *p2, void *p3);
+
+K_THREAD_DEFINE(metrics_archive_thread, 2048, metrics_archive_thread_fn, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, SYS_FOREVER_MS);
+
+static K_MUTEX_DEFINE(archive_mutex);
+static struct metrics_archive_provider archive_provider;
+static struct fs_file_t archive_file;
+/*
+ * Samples are collected here and written as one page once it is full.
+ * The buffer comes from the metrics heap and is kept for the whole run.
+ * Records are numbered by a sequence that survives reboots; record `seq`
+ * always lives in page (seq / RECORDS_PER_PAGE) % ARCHIVE_PAGES.
+ */
+static struct metrics_record *page_buf;
+static uint32_t next_seq;
+static uint16_t boot_count;
+
+static uint8_t record_crc(const struct metrics_record *record)
+{
+	return crc8_ccitt(0xff, record, offsetof(struct metrics_record, crc));
+}
+
+static bool record_valid(const struct metrics_record *record, uint32_t seq)
+{
+	return (record->seq == seq) && (record->crc == record_crc(record));
+}
+
+static off_t record_offset(uint32_t seq)
+{
+	return (off_t)(((seq / RECORDS_PER_PAGE) % ARCHIVE_PAGES) * PAGE_SIZE +
+		       (seq % RECORDS_PER_PAGE) * sizeof(struct metrics_record));
+}
+
+static int read_records(uint32_t seq, struct metrics_record *out, size_t count)
+{
+	ssize_t len;
+	int ret;
+
+	ret = fs_seek(&archive_file, record_offset(seq), FS_SEEK_SET);
+	if (ret < 0) {
+		return ret;
+	}
+
+	len = fs_read(&archive_file, out, count * sizeof(*out));
+	if (len < 0) {
+		return (int)len;
+	}
+
+	return ((size_t)len == count * sizeof(*out)) ? 0 : -EIO;
+}
+
+static int flush_page(uint32_t first_seq)
+{
+	ssize_t len;
+	int ret;
+
+	ret = fs_seek(&archive_file, record_offset(first_seq), FS_SEEK_SET);
+	if (ret < 0) {
+		return ret;
+	}
+
+	len = fs_write(&archive_file, page_buf, PAGE_SIZE);
+	if (len < 0) {
+		return (int)len;
+	}
+
+	if ((size_t)len != PAGE_SIZE) {
+		return -EIO;
+	}
+
+	return fs_sync(&archive_file);
+}
+
+/* Find the newest complete page to continue the sequence and boot counter. */
+static int recover_position(void)
+{
+	struct metrics_record first;
+	uint32_t newest_seq = 0U;
+	bool found = false;
+	int ret;
+
+	for (uint32_t page = 0U; page < ARCHIVE_PAGES; page++) {
+		ret = fs_seek(&archive_file, (off_t)(page * PAGE_SIZE), FS_SEEK_SET);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (fs_read(&archive_file, &first, sizeof(first)) != sizeof(first)) {
+			return -EIO;
+		}
+
+		if ((first.crc != record_crc(&first)) ||
+		    (((first.seq / RECORDS_PER_PAGE) % ARCHIVE_PAGES) != page)) {
+			continue;
+		}
+
+		if (!found || (first.seq > newest_seq)) {
+			newest_seq = first.seq;
+			found = true;
+		}
+	}
+
+	next_seq = 0U;
+	boot_count = 0U;
+	if (!found) {
+		return 0;
+	}
+
+	ret = read_records(newest_seq, page_buf, RECORDS_PER_PAGE);
+	if (ret < 0) {
+		return ret;
+	}
+
+	for (size_t i = 0; i < RECORDS_PER_PAGE; i++) {
+		if (record_valid(&page_buf[i], newest_seq + i)) {
+			boot_count = MAX(boot_count, (uint16_t)(page_buf[i].boot_count + 1U));
+		}
+	}
+
+	next_seq = newest_seq + RECORDS_PER_PAGE;
+	return 0;
+}
+
+int metrics_archive_init(const struct metrics_archive_provider *provider)
+{
+	struct fs_dirent entry;
+	int ret;
+
+	if (provider == NULL) {
+		return -EINVAL;
+	}
+
+	if (page_buf == NULL) {
+		page_buf = app_utils_heap_alloc(APP_HEAP_METRICS, PAGE_SIZE);
+		if (page_buf == NULL) {
+			return -ENOMEM;
+		}
+	}
+
+	archive_provider = *provider;
+	fs_file_t_init(&archive_file);
+
+	ret = fs_open(&archive_file, ARCHIVE_PATH, FS_O_CREATE | FS_O_RDWR);
+	if (ret < 0) {
+		LOG_ERR("Failed to open %s (%d)", ARCHIVE_PATH, ret);
+		return ret;
+	}
+
+	ret = fs_stat(ARCHIVE_PATH, &entry);
+	if ((ret == 0) && (entry.size != ARCHIVE_SIZE)) {
+		/* Geometry changed or new file: start over with a zeroed archive. */
+		LOG_INF("Resetting %s to %d bytes", ARCHIVE_PATH, ARCHIVE_SIZE);
+		ret = fs_truncate(&archive_file, 0);
+		if (ret == 0) {
+			ret = fs_truncate(&archive_file, ARCHIVE_SIZE);
+		}
+	}
+
+	if (ret == 0) {
+		ret = recover_position();
+	}
+
+	if (ret < 0) {
+		LOG_ERR("Metrics archive init failed (%d)", ret);
+		(void)fs_close(&archive_file);
+		return ret;
+	}
+
+	LOG_INF("Metrics archive: boot %u, next record %u", boot_count, next_seq);
+	return 0;
+}
+
+void metrics_archive_start(void)
+{
+	k_thread_start(metrics_archive_thread);
+}
+
+uint32_t metrics_archive_next_seq(void)
+{
+	return next_seq;
+}
+
+uint32_t metrics_archive_oldest_seq(void)
+{
+	uint32_t next = next_seq;
+
+	return (next > ARCHIVE_RECORDS) ? (next - ARCHIVE_RECORDS) : 0U;
+}
+
+static void metrics_archive_sample(void)
+{
+	struct metrics_record record = {
+		.uptime_s = (uint32_t)(k_uptime_get() / MSEC_PER_SEC),
+		.boot_count = boot_count,
+		.cpu_percent = -1,
+		.ram_percent = -1,
+		.rssi_dbm = METRICS_ARCHIVE_RSSI_UNKNOWN,
+	};
+	int rssi;
+	int ret;
+
+	if (archive_provider.get_cpu_util_percent != NULL) {
+		record.cpu_percent = (int8_t)archive_provider.get_cpu_util_percent();
+	}
+
+	if (archive_provider.get_ram_util_percent != NULL) {
+		record.ram_percent = (int8_t)archive_provider.get_ram_util_percent();
+	}
+
+	if ((archive_provider.get_rssi != NULL) && (archive_provider.get_rssi(&rssi) == 0)) {
+		record.rssi_dbm = (int8_t)CLAMP(rssi, INT8_MIN + 1, INT8_MAX);
+	}
+
+	if (archive_provider.get_reconnect_count != NULL) {
+		record.wifi_reconnects = (uint16_t)archive_provider.get_reconnect_count();
+	}
+
+	k_mutex_lock(&archive_mutex, K_FOREVER);
+
+	record.seq = next_seq;
+	record.crc = record_crc(&record);
+	page_buf[next_seq % RECORDS_PER_PAGE] = record;
+	next_seq++;
+
+	if ((next_seq % RECORDS_PER_PAGE) == 0U) {
+		ret = flush_page(next_seq - RECORDS_PER_PAGE);
+		if (ret < 0) {
+			LOG_ERR("Metrics page write failed (%d)", ret);
+		}
+	}
+
+	k_mutex_unlock(&archive_mutex);
+}
+
+size_t metrics_archive_read(uint32_t *seq, struct metrics_record *out, size_t max_records)
+{
+	size_t count = 0U;
+	uint32_t pending_start;
+	size_t run;
+	int ret;
+
+	k_mutex_lock(&archive_mutex, K_FOREVER);
+
+	*seq = MAX(*seq, metrics_archive_oldest_seq());
+	pending_start = next_seq - (next_seq % RECORDS_PER_PAGE);
+
+	while ((count < max_records) && (*seq < next_seq)) {
+		if (*seq >= pending_start) {
+			out[count++] = page_buf[*seq % RECORDS_PER_PAGE];
+			(*seq)++;
+			continue;
+		}
+
+		run = MIN(max_records - count, RECORDS_PER_PAGE - (*seq % RECORDS_PER_PAGE));
+		run = MIN(run, pending_start - *seq);
+		ret = read_records(*seq, &out[count], run);
+		if (ret < 0) {
+			LOG_ERR("Metrics archive read failed (%d)", ret);
+			break;
+		}
+
+		/* Drop records that never made it to flash, e.g. from an unclean reboot. */
+		for (size_t i = 0; i < run; i++) {
+			if (record_valid(&out[count], *seq)) {
+				count++;
+			} else if (i + 1U < run) {
+				memmove(&out[count], &out[count + 1U],
+					(run - i - 1U) * sizeof(*out));
+			}
+			(*seq)++;
+		}
+	}
+
+	k_mutex_unlock(&archive_mutex);
+	return count;
+}
+
+static void metrics_archive_thread_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sleep(K_SECONDS(CONFIG_APP_METRICS_ARCHIVE_PERIOD_S));
+		metrics_archive_sample();
+	}
+}
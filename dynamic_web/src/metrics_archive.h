@@ -0,0 +1,37 @@
+#ifndef METRICS_ARCHIVE_H
+#define METRICS_ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/toolchain.h>
+
+#define METRICS_ARCHIVE_RSSI_UNKNOWN INT8_MIN
+
+struct metrics_archive_provider {
+	int (*get_cpu_util_percent)(void);
+	int (*get_ram_util_percent)(void);
+	int (*get_rssi)(int *rssi_dbm);
+	uint32_t (*get_reconnect_count)(void);
+};
+
+/* One sample. 16 bytes, so a flash program page holds a whole number of records. */
+struct metrics_record {
+	uint32_t seq;
+	uint32_t uptime_s;
+	uint16_t boot_count;
+	uint16_t wifi_reconnects;
+	int8_t cpu_percent;
+	int8_t ram_percent;
+	int8_t rssi_dbm;
+	uint8_t crc;
+} __packed;
+
+int metrics_archive_init(const struct metrics_archive_provider *provider);
+void metrics_archive_start(void);
+uint32_t metrics_archive_oldest_seq(void);
+uint32_t metrics_archive_next_seq(void);
+/* Copy up to max_records valid records starting at *seq and advance *seq past them. */
+size_t metrics_archive_read(uint32_t *seq, struct metrics_record *out, size_t max_records);
+
+#endif
@@ -0,0 +1,128 @@
+#include "net_stats.h"
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/net_context.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_stats.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/sys/iterable_sections.h>
+
+struct slab_usage {
+	uint32_t used;
+	uint32_t total;
+	int max_used;
+};
+
+struct socket_counts {
+	int tcp;
+	int udp;
+	int other;
+};
+
+static void slab_usage_get(struct k_mem_slab *slab, struct slab_usage *usage)
+{
+	usage->used = k_mem_slab_num_used_get(slab);
+	usage->total = usage->used + k_mem_slab_num_free_get(slab);
+	usage->max_used = -1;
+
+#if defined(CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION)
+	usage->max_used = (int)k_mem_slab_max_used_get(slab);
+#endif
+}
+
+int net_stats_format_pkt(char *buf, size_t buf_len)
+{
+	struct k_mem_slab *rx;
+	struct k_mem_slab *tx;
+	struct net_buf_pool *rx_data;
+	struct net_buf_pool *tx_data;
+	struct slab_usage rx_usage;
+	struct slab_usage tx_usage;
+
+	net_pkt_get_info(&rx, &tx, &rx_data, &tx_data);
+	slab_usage_get(rx, &rx_usage);
+	slab_usage_get(tx, &tx_usage);
+
+	return snprintk(buf, buf_len,
+			"{\"rx\":{\"used\":%u,\"max_used\":%d,\"total\":%u},"
+			"\"tx\":{\"used\":%u,\"max_used\":%d,\"total\":%u}}",
+			rx_usage.used, rx_usage.max_used, rx_usage.total, tx_usage.used,
+			tx_usage.max_used, tx_usage.total);
+}
+
+int net_stats_format_tcp(char *buf, size_t buf_len)
+{
+#if defined(CONFIG_NET_STATISTICS_TCP) && defined(CONFIG_NET_STATISTICS_USER_API)
+	struct net_stats_tcp tcp;
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_TCP, NULL, &tcp, sizeof(tcp));
+	if (ret < 0) {
+		return ret;
+	}
+
+	return snprintk(buf, buf_len,
+			"{\"bytes_sent\":%llu,\"bytes_received\":%llu,\"rexmit\":%llu,"
+			"\"resent\":%llu,\"drop\":%llu,\"conndrop\":%llu,\"connrst\":%llu}",
+			(unsigned long long)tcp.bytes.sent, (unsigned long long)tcp.bytes.received,
+			(unsigned long long)tcp.rexmit, (unsigned long long)tcp.resent,
+			(unsigned long long)tcp.drop, (unsigned long long)tcp.conndrop,
+			(unsigned long long)tcp.connrst);
+#else
+	ARG_UNUSED(buf);
+	ARG_UNUSED(buf_len);
+
+	return -ENOTSUP;
+#endif
+}
+
+static void count_context(struct net_context *context, void *user_data)
+{
+	struct socket_counts *counts = user_data;
+
+	switch (net_context_get_proto(context)) {
+	case IPPROTO_TCP:
+		counts->tcp++;
+		break;
+	case IPPROTO_UDP:
+		counts->udp++;
+		break;
+	default:
+		counts->other++;
+		break;
+	}
+}
+
+int net_stats_format_sockets(char *buf, size_t buf_len)
+{
+	struct socket_counts counts = { 0 };
+
+	net_context_foreach(count_context, &counts);
+
+	return snprintk(buf, buf_len, "{\"tcp\":%d,\"udp\":%d,\"other\":%d,\"max\":%d}",
+			counts.tcp, counts.udp, counts.other, CONFIG_NET_MAX_CONTEXTS);
+}
+
+int net_stats_format_buf_pool(size_t index, char *buf, size_t buf_len)
+{
+	struct net_buf_pool *pool;
+	int count;
+
+	STRUCT_SECTION_COUNT(net_buf_pool, &count);
+	if (index >= (size_t)count) {
+		return -ENOENT;
+	}
+
+	STRUCT_SECTION_GET(net_buf_pool, index, &pool);
+
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	return snprintk(buf, buf_len, "{\"name\":\"%s\",\"total\":%u,\"avail\":%d,\"max_used\":%u}",
+			pool->name, pool->buf_count, (int)atomic_get(&pool->avail_count),
+			pool->max_used);
+#else
+	return snprintk(buf, buf_len, "{\"total\":%u}", pool->buf_count);
+#endif
+}
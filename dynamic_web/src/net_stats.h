@@ -0,0 +1,16 @@
+#ifndef NET_STATS_H
+#define NET_STATS_H
+
+#include <stddef.h>
+
+/*
+ * JSON values for /api/net. Each writes one value and returns its length
+ * like snprintk, or a negative errno when the value is unavailable.
+ */
+int net_stats_format_pkt(char *buf, size_t buf_len);
+int net_stats_format_tcp(char *buf, size_t buf_len);
+int net_stats_format_sockets(char *buf, size_t buf_len);
+/* Returns -ENOENT once index is past the last registered net_buf pool. */
+int net_stats_format_buf_pool(size_t index, char *buf, size_t buf_len);
+
+#endif
@@ -0,0 +1,164 @@
+#include "ota_service.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <psa/crypto.h>
+#include <zephyr/dfu/flash_img.h>
+#include <zephyr/dfu/mcuboot.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/reboot.h>
+
+LOG_MODULE_REGISTER(ota_service, LOG_LEVEL_INF);
+
+/* ih_magic at the start of every MCUboot image header. */
+#define OTA_IMAGE_MAGIC 0x96f3b83dU
+#define OTA_REBOOT_DELAY K_SECONDS(1)
+
+static struct flash_img_context img_ctx;
+static psa_hash_operation_t hash_op;
+static bool in_progress;
+static size_t received;
+static int64_t started_ms;
+
+static void reboot_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	LOG_INF("Rebooting into test image");
+	sys_reboot(SYS_REBOOT_COLD);
+}
+
+static K_WORK_DELAYABLE_DEFINE(reboot_work, reboot_work_handler);
+
+int ota_service_begin(void)
+{
+	int ret;
+
+	if (in_progress) {
+		return -EBUSY;
+	}
+
+	if (psa_crypto_init() != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	/*
+	 * Targets the slot1 partition. Pages are erased as the write-behind
+	 * buffer reaches them (CONFIG_IMG_ERASE_PROGRESSIVELY), so the upload
+	 * does not wait for a full slot erase up front.
+	 */
+	ret = flash_img_init(&img_ctx);
+	if (ret < 0) {
+		LOG_ERR("Secondary slot open failed (%d)", ret);
+		return ret;
+	}
+
+	hash_op = psa_hash_operation_init();
+	if (psa_hash_setup(&hash_op, PSA_ALG_SHA_256) != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	in_progress = true;
+	received = 0U;
+	started_ms = k_uptime_get();
+	LOG_INF("OTA upload started");
+	return 0;
+}
+
+int ota_service_write(const uint8_t *data, size_t len)
+{
+	int ret;
+
+	if (!in_progress) {
+		return -EINVAL;
+	}
+
+	if (len == 0U) {
+		return 0;
+	}
+
+	/* Refuse obvious garbage before the first page of slot1 is erased. */
+	if ((received == 0U) && (len >= sizeof(uint32_t)) &&
+	    (sys_get_le32(data) != OTA_IMAGE_MAGIC)) {
+		LOG_ERR("Upload is not an MCUboot image");
+		ota_service_abort();
+		return -ENOEXEC;
+	}
+
+	/* Hash the bytes as received so no read-back pass over flash is needed. */
+	if (psa_hash_update(&hash_op, data, len) != PSA_SUCCESS) {
+		ota_service_abort();
+		return -EIO;
+	}
+
+	ret = flash_img_buffered_write(&img_ctx, data, len, false);
+	if (ret < 0) {
+		LOG_ERR("Image write failed at %zu (%d)", received, ret);
+		ota_service_abort();
+		return ret;
+	}
+
+	received += len;
+	return 0;
+}
+
+int ota_service_finish(const uint8_t *expected, uint8_t sha256[OTA_SERVICE_SHA256_LEN],
+		       size_t *image_len)
+{
+	size_t hash_len;
+	int64_t elapsed_ms;
+	int ret;
+
+	if (!in_progress) {
+		return -EINVAL;
+	}
+
+	ret = flash_img_buffered_write(&img_ctx, NULL, 0, true);
+	if (ret < 0) {
+		LOG_ERR("Image flush failed (%d)", ret);
+		ota_service_abort();
+		return ret;
+	}
+
+	in_progress = false;
+	if (psa_hash_finish(&hash_op, sha256, OTA_SERVICE_SHA256_LEN, &hash_len) != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	*image_len = flash_img_bytes_written(&img_ctx);
+	if ((expected != NULL) && (memcmp(expected, sha256, OTA_SERVICE_SHA256_LEN) != 0)) {
+		LOG_ERR("Image digest mismatch");
+		return -EBADMSG;
+	}
+
+	ret = boot_request_upgrade(BOOT_UPGRADE_TEST);
+	if (ret < 0) {
+		LOG_ERR("Marking image for test failed (%d)", ret);
+		return ret;
+	}
+
+	elapsed_ms = MAX(k_uptime_get() - started_ms, 1);
+	LOG_INF("OTA image %zu bytes in %lld ms (%lld KiB/s), marked for test", *image_len,
+		elapsed_ms, ((int64_t)*image_len * 1000 / elapsed_ms) / 1024);
+	return 0;
+}
+
+void ota_service_abort(void)
+{
+	if (!in_progress) {
+		return;
+	}
+
+	(void)psa_hash_abort(&hash_op);
+	in_progress = false;
+	LOG_WRN("OTA upload aborted after %zu bytes", received);
+}
+
+void ota_service_schedule_reboot(void)
+{
+	(void)k_work_schedule(&reboot_work, OTA_REBOOT_DELAY);
+}
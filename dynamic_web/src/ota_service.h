@@ -0,0 +1,27 @@
+#ifndef OTA_SERVICE_H
+#define OTA_SERVICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define OTA_SERVICE_SHA256_LEN 32
+
+/* Open the MCUboot secondary slot and start hashing a new upload. */
+int ota_service_begin(void);
+
+/* Hash and write the next part of the image through the write-behind buffer. */
+int ota_service_write(const uint8_t *data, size_t len);
+
+/*
+ * Flush the image, check it against `expected` (may be NULL) and mark it for
+ * a test boot. `sha256` receives the digest of the received bytes.
+ */
+int ota_service_finish(const uint8_t *expected, uint8_t sha256[OTA_SERVICE_SHA256_LEN],
+		       size_t *image_len);
+
+/* Drop an upload in progress. The secondary slot is left unmarked. */
+void ota_service_abort(void);
+
+void ota_service_schedule_reboot(void);
+
+#endif
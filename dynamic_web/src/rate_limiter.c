@@ -0,0 +1,107 @@
+#include "rate_limiter.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(rate_limiter, LOG_LEVEL_INF);
+
+/* Token counts are kept in thousandths so refill works with millisecond deltas. */
+#define TOKEN_SCALE     1000U
+#define BUCKET_CAPACITY (CONFIG_APP_RATE_LIMIT_BURST * TOKEN_SCALE)
+
+struct rate_bucket {
+	uint32_t addr;
+	uint32_t tokens;
+	int64_t last_ms;
+};
+
+static struct rate_bucket buckets[CONFIG_APP_RATE_LIMIT_TRACKED_CLIENTS];
+static uint32_t allowed_count;
+static uint32_t limited_count;
+static struct k_spinlock lock;
+
+static struct rate_bucket *bucket_get(uint32_t addr, int64_t now_ms)
+{
+	struct rate_bucket *oldest = &buckets[0];
+
+	for (size_t i = 0; i < ARRAY_SIZE(buckets); i++) {
+		if ((buckets[i].addr == addr) && (buckets[i].last_ms != 0)) {
+			return &buckets[i];
+		}
+
+		if (buckets[i].last_ms < oldest->last_ms) {
+			oldest = &buckets[i];
+		}
+	}
+
+	/* Reuse the least recently seen entry for a new address. */
+	oldest->addr = addr;
+	oldest->tokens = BUCKET_CAPACITY;
+	oldest->last_ms = now_ms;
+	return oldest;
+}
+
+bool rate_limiter_admit(const struct http_client_ctx *client)
+{
+	struct sockaddr_in peer;
+	socklen_t peer_len = sizeof(peer);
+	struct rate_bucket *bucket;
+	k_spinlock_key_t key;
+	int64_t now_ms;
+	uint64_t refill;
+	bool admit;
+
+	if ((zsock_getpeername(client->fd, (struct sockaddr *)&peer, &peer_len) < 0) ||
+	    (peer.sin_family != AF_INET)) {
+		return true;
+	}
+
+	now_ms = k_uptime_get();
+	if (now_ms == 0) {
+		now_ms = 1;
+	}
+
+	key = k_spin_lock(&lock);
+
+	bucket = bucket_get(peer.sin_addr.s_addr, now_ms);
+	refill = (uint64_t)(now_ms - bucket->last_ms) * CONFIG_APP_RATE_LIMIT_RPS;
+	bucket->tokens = (uint32_t)MIN((uint64_t)bucket->tokens + refill, BUCKET_CAPACITY);
+	bucket->last_ms = now_ms;
+
+	admit = (bucket->tokens >= TOKEN_SCALE);
+	if (admit) {
+		bucket->tokens -= TOKEN_SCALE;
+		allowed_count++;
+	} else {
+		limited_count++;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if (!admit) {
+		LOG_DBG("Rate limited %d.%d.%d.%d", peer.sin_addr.s4_addr[0],
+			peer.sin_addr.s4_addr[1], peer.sin_addr.s4_addr[2],
+			peer.sin_addr.s4_addr[3]);
+	}
+
+	return admit;
+}
+
+void rate_limiter_get_stats(struct rate_limiter_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stats->allowed = allowed_count;
+	stats->limited = limited_count;
+	stats->tracked_clients = 0U;
+	for (size_t i = 0; i < ARRAY_SIZE(buckets); i++) {
+		if (buckets[i].last_ms != 0) {
+			stats->tracked_clients++;
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+}
@@ -0,0 +1,18 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/net/http/server.h>
+
+struct rate_limiter_stats {
+	uint32_t allowed;
+	uint32_t limited;
+	uint32_t tracked_clients;
+};
+
+bool rate_limiter_admit(const struct http_client_ctx *client);
+void rate_limiter_get_stats(struct rate_limiter_stats *stats);
+
+#endif
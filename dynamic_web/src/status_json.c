@@ -0,0 +1,91 @@
+#include "status_json.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+struct status_json_slot {
+	const char *key;
+	uint8_t width;
+};
+
+/* Widths fit the largest value: 20 digits for int64, quoted and escaped 32-byte SSID. */
+static const struct status_json_slot slots[STATUS_JSON_FIELD_COUNT] = {
+	[STATUS_JSON_VERSION] = { "version", 10 },
+	[STATUS_JSON_UPTIME_MS] = { "uptime_ms", 20 },
+	[STATUS_JSON_IP] = { "ip", 17 },
+	[STATUS_JSON_SSID] = { "ssid", 66 },
+	[STATUS_JSON_CPU_LOAD_PERCENT] = { "cpu_load_percent", 4 },
+	[STATUS_JSON_RAM_UTIL_PERCENT] = { "ram_util_percent", 4 },
+};
+
+static uint16_t slot_offsets[STATUS_JSON_FIELD_COUNT];
+static size_t template_len;
+
+size_t status_json_init(char *buf, size_t buf_len)
+{
+	size_t len = 0U;
+
+	buf[len++] = '{';
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		len += snprintk(&buf[len], buf_len - len, "%s\"%s\":", (i == 0U) ? "" : ",",
+				slots[i].key);
+		slot_offsets[i] = (uint16_t)len;
+		memset(&buf[len], ' ', slots[i].width);
+		len += slots[i].width;
+	}
+	buf[len++] = '}';
+
+	__ASSERT(len <= buf_len, "status JSON template does not fit");
+	template_len = len;
+	return len;
+}
+
+size_t status_json_len(void)
+{
+	return template_len;
+}
+
+void status_json_patch_int(char *buf, enum status_json_field field, int64_t value)
+{
+	char *slot = &buf[slot_offsets[field]];
+	uint8_t width = slots[field].width;
+	uint64_t magnitude = (value < 0) ? (uint64_t)(-value) : (uint64_t)value;
+	int pos = width;
+
+	/* Right-align so the leading padding is whitespace before the number. */
+	do {
+		slot[--pos] = (char)('0' + (magnitude % 10U));
+		magnitude /= 10U;
+	} while ((magnitude != 0U) && (pos > 0));
+
+	if ((value < 0) && (pos > 0)) {
+		slot[--pos] = '-';
+	}
+
+	memset(slot, ' ', pos);
+}
+
+void status_json_patch_str(char *buf, enum status_json_field field, const char *value)
+{
+	char *slot = &buf[slot_offsets[field]];
+	uint8_t width = slots[field].width;
+	int pos = 0;
+
+	slot[pos++] = '"';
+	for (; (*value != '\0') && (pos < width - 1); value++) {
+		if ((*value == '"') || (*value == '\\')) {
+			if (pos >= width - 2) {
+				break;
+			}
+			slot[pos++] = '\\';
+		} else if ((uint8_t)*value < 0x20) {
+			continue;
+		}
+		slot[pos++] = *value;
+	}
+	slot[pos++] = '"';
+
+	memset(&slot[pos], ' ', width - pos);
+}
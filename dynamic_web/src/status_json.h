@@ -0,0 +1,30 @@
+#ifndef STATUS_JSON_H
+#define STATUS_JSON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * /api/status body with a fixed layout. Every value occupies a fixed-width
+ * slot padded with JSON whitespace, so values are patched in place and the
+ * body length never changes.
+ */
+enum status_json_field {
+	STATUS_JSON_VERSION,
+	STATUS_JSON_UPTIME_MS,
+	STATUS_JSON_IP,
+	STATUS_JSON_SSID,
+	STATUS_JSON_CPU_LOAD_PERCENT,
+	STATUS_JSON_RAM_UTIL_PERCENT,
+	STATUS_JSON_FIELD_COUNT,
+};
+
+#define STATUS_JSON_MAX_LEN 224
+
+/* Write the template with empty slots into buf and return its length. */
+size_t status_json_init(char *buf, size_t buf_len);
+size_t status_json_len(void);
+void status_json_patch_int(char *buf, enum status_json_field field, int64_t value);
+void status_json_patch_str(char *buf, enum status_json_field field, const char *value);
+
+#endif
@@ -1,33 +1,293 @@
 #include "webserver_service.h"
 
 #include <errno.h>
+#include <stdarg.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/net/http/server.h>
 #include <zephyr/net/http/service.h>
 #include <zephyr/net/net_ip.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
 
+#include "api_router.h"
+#include "app_utils.h"
+#include "asset_handler.h"
+#include "boot_timeline.h"
 #include "filesystem_service.h"
+#include "log_service.h"
+#include "metrics_archive.h"
+#include "net_stats.h"
+#include "ota_service.h"
+#include "rate_limiter.h"
+#include "status_json.h"
 
 LOG_MODULE_REGISTER(webserver_service, LOG_LEVEL_INF);
 
+/* The SSID slot of the status JSON holds at most 32 bytes. */
+#define STATUS_SSID_MAX_LEN 32
+
+struct status_snapshot {
+	/* Odd while the writer is filling this slot. */
+	atomic_t seq;
+	/*
+	 * Bumped only when a rendered value other than uptime_ms changes;
+	 * clients advance uptime on their own between changes.
+	 */
+	uint32_t version;
+	char ip[NET_IPV4_ADDR_LEN];
+	char ssid[STATUS_SSID_MAX_LEN + 1];
+	int cpu_load_percent;
+	int ram_util_percent;
+	/* Pre-rendered /api/status body, patched in place on each refresh. */
+	char json[STATUS_JSON_MAX_LEN];
+};
+
+BUILD_ASSERT(CONFIG_APP_STATUS_RESPONSE_BUF_SIZE >= STATUS_JSON_MAX_LEN,
+	     "Response buffer must hold the status JSON template");
+
+struct log_stream {
+	bool active;
+	uint32_t cursor;
+	/* Write position when the request arrived; the response stops there. */
+	uint32_t end;
+	/* Setting headers replaces the route's Content-Type, so carry both. */
+	struct http_header headers[2];
+	char end_str[11];
+};
+
+struct archive_stream {
+	bool active;
+	bool first;
+	uint32_t seq;
+	uint32_t remaining;
+};
+
+struct net_stream {
+	bool active;
+	uint32_t step;
+};
+
+struct response_buf {
+	uint8_t data[CONFIG_APP_STATUS_RESPONSE_BUF_SIZE];
+	/* A client runs one request at a time, so streams share storage. */
+	union {
+		struct log_stream logs;
+		struct archive_stream archive;
+		struct net_stream net;
+	};
+};
+
 static struct webserver_status_provider status_provider;
 static uint16_t http_port = 80;
 
+static const struct http_header retry_after_headers[] = {
+	{ .name = "Retry-After", .value = "1" },
+};
+
+/* Far more than the writer can lap the reader, bar a stalled server thread. */
+#define STATUS_SNAPSHOT_COPY_ATTEMPTS 8
+
+static struct status_snapshot status_snapshots[2];
+static atomic_ptr_t current_snapshot = ATOMIC_PTR_INIT(NULL);
+static atomic_ptr_t response_buf_owners[CONFIG_HTTP_SERVER_MAX_CLIENTS];
+/* Allocated from the HTTP heap when a slot is first claimed. */
+static struct response_buf *response_bufs[CONFIG_HTTP_SERVER_MAX_CLIENTS];
+
+static void status_snapshot_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(status_snapshot_work, status_snapshot_work_handler);
+
+static void status_snapshot_refresh(void)
+{
+	struct status_snapshot *cur = atomic_ptr_get(&current_snapshot);
+	struct status_snapshot *next =
+		(cur == &status_snapshots[0]) ? &status_snapshots[1] : &status_snapshots[0];
+
+	(void)atomic_inc(&next->seq);
+
+	strcpy(next->ip, "0.0.0.0");
+	strcpy(next->ssid, "unknown");
+	next->cpu_load_percent = -1;
+	next->ram_util_percent = -1;
+
+	if (status_provider.get_ipv4_addr != NULL) {
+		(void)status_provider.get_ipv4_addr(next->ip, sizeof(next->ip));
+	}
+
+	if (status_provider.get_ssid != NULL) {
+		const char *ssid = status_provider.get_ssid();
+
+		if (ssid != NULL) {
+			strncpy(next->ssid, ssid, STATUS_SSID_MAX_LEN);
+			next->ssid[STATUS_SSID_MAX_LEN] = '\0';
+		}
+	}
+
+	if (status_provider.get_cpu_util_percent != NULL) {
+		next->cpu_load_percent = status_provider.get_cpu_util_percent();
+	}
+
+	if (status_provider.get_ram_util_percent != NULL) {
+		next->ram_util_percent = status_provider.get_ram_util_percent();
+	}
+
+	if (cur == NULL) {
+		next->version = 1U;
+	} else if ((strcmp(next->ip, cur->ip) != 0) || (strcmp(next->ssid, cur->ssid) != 0) ||
+		   (next->cpu_load_percent != cur->cpu_load_percent) ||
+		   (next->ram_util_percent != cur->ram_util_percent)) {
+		next->version = cur->version + 1U;
+	} else {
+		next->version = cur->version;
+	}
+
+	status_json_patch_int(next->json, STATUS_JSON_VERSION, next->version);
+	status_json_patch_int(next->json, STATUS_JSON_UPTIME_MS, k_uptime_get());
+	status_json_patch_str(next->json, STATUS_JSON_IP, next->ip);
+	status_json_patch_str(next->json, STATUS_JSON_SSID, next->ssid);
+	status_json_patch_int(next->json, STATUS_JSON_CPU_LOAD_PERCENT, next->cpu_load_percent);
+	status_json_patch_int(next->json, STATUS_JSON_RAM_UTIL_PERCENT, next->ram_util_percent);
+
+	(void)atomic_inc(&next->seq);
+	atomic_ptr_set(&current_snapshot, next);
+}
+
+static void status_snapshot_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	status_snapshot_refresh();
+	(void)k_work_schedule(&status_snapshot_work, K_MSEC(CONFIG_APP_STATUS_SNAPSHOT_PERIOD_MS));
+}
+
+/*
+ * Lock-free copy of the latest rendered status. The writer only fills the
+ * slot that is not published, so a retry is needed only if it wrapped around
+ * twice while we were copying. Returns -EAGAIN rather than a torn or stale
+ * copy when no consistent snapshot could be read.
+ */
+static int status_snapshot_copy_json(char *out)
+{
+	for (int attempt = 0; attempt < STATUS_SNAPSHOT_COPY_ATTEMPTS; attempt++) {
+		const struct status_snapshot *snap = atomic_ptr_get(&current_snapshot);
+		atomic_val_t seq;
+
+		if (snap == NULL) {
+			return -EAGAIN;
+		}
+
+		seq = atomic_get(&snap->seq);
+		if ((seq & 1) != 0) {
+			k_yield();
+			continue;
+		}
+
+		memcpy(out, snap->json, status_json_len());
+
+		if (atomic_get(&snap->seq) == seq) {
+			return 0;
+		}
+	}
+
+	return -EAGAIN;
+}
+
+/* 0 until the first snapshot is published; published versions start at 1. */
+static uint32_t status_snapshot_version(void)
+{
+	const struct status_snapshot *snap = atomic_ptr_get(&current_snapshot);
+
+	return (snap == NULL) ? 0U : snap->version;
+}
+
+/* The slot already claimed by client, or NULL without claiming one. */
+static struct response_buf *response_buf_find(struct http_client_ctx *client)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(response_bufs); i++) {
+		if (atomic_ptr_get(&response_buf_owners[i]) == client) {
+			return response_bufs[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct response_buf *response_buf_get(struct http_client_ctx *client)
+{
+	struct response_buf *buf = response_buf_find(client);
+
+	if (buf != NULL) {
+		return buf;
+	}
+
+	/* Client contexts live in a fixed array, so a claimed slot is never released. */
+	for (size_t i = 0; i < ARRAY_SIZE(response_bufs); i++) {
+		if (!atomic_ptr_cas(&response_buf_owners[i], NULL, client)) {
+			continue;
+		}
+
+		if (response_bufs[i] == NULL) {
+			response_bufs[i] = app_utils_heap_alloc(APP_HEAP_HTTP, sizeof(*response_bufs[i]));
+			if (response_bufs[i] == NULL) {
+				atomic_ptr_set(&response_buf_owners[i], NULL);
+				return NULL;
+			}
+
+			memset(response_bufs[i], 0, sizeof(*response_bufs[i]));
+		}
+
+		return response_bufs[i];
+	}
+
+	return NULL;
+}
+
+/* Answer with 429 when the client's address has exhausted its token bucket. */
+static bool reject_if_rate_limited(struct http_client_ctx *client,
+				   struct http_response_ctx *response_ctx)
+{
+	if (rate_limiter_admit(client)) {
+		return false;
+	}
+
+	response_ctx->status = HTTP_429_TOO_MANY_REQUESTS;
+	response_ctx->headers = retry_after_headers;
+	response_ctx->header_count = ARRAY_SIZE(retry_after_headers);
+	response_ctx->final_chunk = true;
+	return true;
+}
+
+/* Append to a response body, failing instead of letting len run past the buffer. */
+static int response_append(struct response_buf *buf, int *len, const char *fmt, ...)
+{
+	size_t space = sizeof(buf->data) - (size_t)*len;
+	va_list args;
+	int ret;
+
+	va_start(args, fmt);
+	ret = vsnprintk((char *)&buf->data[*len], space, fmt, args);
+	va_end(args);
+
+	if ((ret < 0) || ((size_t)ret >= space)) {
+		return -ENOMEM;
+	}
+
+	*len += ret;
+	return 0;
+}
+
 static int api_status_handler(struct http_client_ctx *client, enum http_data_status status,
 			      const struct http_request_ctx *request_ctx,
 			      struct http_response_ctx *response_ctx, void *user_data)
 {
-	static uint8_t payload[320];
-	char ip[NET_IPV4_ADDR_LEN] = "0.0.0.0";
-	const char *ssid = "unknown";
-	int cpu_load_percent = -1;
-	int ram_util_percent = -1;
-	int len;
+	struct response_buf *buf;
+	uint32_t since;
+	char *payload;
 
-	ARG_UNUSED(client);
 	ARG_UNUSED(request_ctx);
 	ARG_UNUSED(user_data);
 
@@ -36,58 +296,570 @@ static int api_status_handler(struct http_client_ctx *client, enum http_data_sta
 	}
 
 	if (status == HTTP_SERVER_DATA_FINAL) {
-		if (status_provider.get_ipv4_addr != NULL) {
-			(void)status_provider.get_ipv4_addr(ip, sizeof(ip));
+		if (reject_if_rate_limited(client, response_ctx)) {
+			return 0;
 		}
 
-		if (status_provider.get_ssid != NULL) {
-			ssid = status_provider.get_ssid();
+		/*
+		 * Never park the request: the server thread serves every client.
+		 * A poll that has already seen the published version gets a 200
+		 * with an empty body. Dynamic responses are always chunked, so a
+		 * 304, which must not carry a body or its framing, is not an option.
+		 */
+		if (api_router_query_param_u32(client->url_buffer, "since", &since) &&
+		    (since == status_snapshot_version())) {
+			response_ctx->final_chunk = true;
+			return 0;
 		}
 
-		if (status_provider.get_cpu_util_percent != NULL) {
-			cpu_load_percent = status_provider.get_cpu_util_percent();
+		buf = response_buf_get(client);
+		if (buf == NULL) {
+			LOG_WRN("No response buffer for client %p", (void *)client);
+			return -ENOMEM;
 		}
 
-		if (status_provider.get_ram_util_percent != NULL) {
-			ram_util_percent = status_provider.get_ram_util_percent();
-		}
+		payload = (char *)buf->data;
 
-		len = snprintk((char *)payload, sizeof(payload),
-			       "{\"uptime_ms\":%lld,\"ip\":\"%s\",\"ssid\":\"%s\",\"cpu_load_percent\":%d,\"ram_util_percent\":%d}",
-			       (long long)k_uptime_get(), ip, ssid, cpu_load_percent, ram_util_percent);
-		if (len < 0) {
-			return len;
+		if (status_snapshot_copy_json(payload) < 0) {
+			response_ctx->status = HTTP_503_SERVICE_UNAVAILABLE;
+			response_ctx->headers = retry_after_headers;
+			response_ctx->header_count = ARRAY_SIZE(retry_after_headers);
+			response_ctx->final_chunk = true;
+			return 0;
 		}
 
-		if (len >= (int)sizeof(payload)) {
-			len = sizeof(payload) - 1;
+		/* Uptime is the only value patched per request. */
+		status_json_patch_int(payload, STATUS_JSON_UPTIME_MS, k_uptime_get());
+
+		response_ctx->body = buf->data;
+		response_ctx->body_len = status_json_len();
+		response_ctx->final_chunk = true;
+	}
+
+	return 0;
+}
+
+/* Serve the boot timeline rendered once by boot_timeline_ready(). */
+static int api_boot_handler(struct http_client_ctx *client, enum http_data_status status,
+			    const struct http_request_ctx *request_ctx,
+			    struct http_response_ctx *response_ctx, void *user_data)
+{
+	const char *body;
+	size_t len;
+
+	ARG_UNUSED(request_ctx);
+	ARG_UNUSED(user_data);
+
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+
+	if (reject_if_rate_limited(client, response_ctx)) {
+		return 0;
+	}
+
+	body = boot_timeline_json(&len);
+	if (body == NULL) {
+		response_ctx->status = HTTP_503_SERVICE_UNAVAILABLE;
+	} else {
+		response_ctx->body = (const uint8_t *)body;
+		response_ctx->body_len = len;
+	}
+
+	response_ctx->final_chunk = true;
+	return 0;
+}
+
+static int api_metrics_handler(struct http_client_ctx *client, enum http_data_status status,
+			       const struct http_request_ctx *request_ctx,
+			       struct http_response_ctx *response_ctx, void *user_data)
+{
+	struct rate_limiter_stats rate_stats;
+	struct app_heap_stats heap_stats;
+	struct response_buf *buf;
+	int len = 0;
+	int ret;
+
+	ARG_UNUSED(request_ctx);
+	ARG_UNUSED(user_data);
+
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+
+	if (reject_if_rate_limited(client, response_ctx)) {
+		return 0;
+	}
+
+	buf = response_buf_get(client);
+	if (buf == NULL) {
+		return -ENOMEM;
+	}
+
+	rate_limiter_get_stats(&rate_stats);
+
+	ret = response_append(buf, &len,
+			      "{\"rate_limit\":{\"allowed\":%u,\"limited\":%u,"
+			      "\"tracked_clients\":%u},\"heaps\":{",
+			      rate_stats.allowed, rate_stats.limited, rate_stats.tracked_clients);
+
+	for (int i = 0; (ret == 0) && (i < APP_HEAP_COUNT); i++) {
+		if (app_utils_get_heap_stats(i, &heap_stats) < 0) {
+			heap_stats = (struct app_heap_stats){ 0 };
 		}
 
-		response_ctx->body = payload;
-		response_ctx->body_len = (size_t)len;
+		ret = response_append(buf, &len,
+				      "%s\"%s\":{\"used\":%zu,\"free\":%zu,\"max_used\":%zu}",
+				      (i == 0) ? "" : ",", app_utils_heap_name(i),
+				      heap_stats.allocated_bytes, heap_stats.free_bytes,
+				      heap_stats.max_allocated_bytes);
+	}
+
+	if (ret == 0) {
+		ret = response_append(buf, &len, "}}");
+	}
+
+	/* A truncated object is not JSON; send nothing rather than half of it. */
+	if (ret < 0) {
+		LOG_ERR("Metrics do not fit in %zu bytes", sizeof(buf->data));
+		response_ctx->status = HTTP_500_INTERNAL_SERVER_ERROR;
 		response_ctx->final_chunk = true;
+		return 0;
 	}
 
+	response_ctx->body = buf->data;
+	response_ctx->body_len = (size_t)len;
+	response_ctx->final_chunk = true;
 	return 0;
 }
 
-static struct http_resource_detail_dynamic api_status_detail = {
+/*
+ * Send the log ring from ?since=<cursor> (or the oldest byte held) up to the
+ * write position at request time, and return that position in X-Log-Cursor
+ * for the next poll. The response never waits for new lines.
+ */
+static int api_logs_handler(struct http_client_ctx *client, enum http_data_status status,
+			    const struct http_request_ctx *request_ctx,
+			    struct http_response_ctx *response_ctx, void *user_data)
+{
+	struct response_buf *buf;
+	struct log_stream *logs;
+	size_t len;
+
+	ARG_UNUSED(request_ctx);
+	ARG_UNUSED(user_data);
+
+	if (status == HTTP_SERVER_DATA_ABORTED) {
+		/* Never claim a buffer just to drop a stream that had none. */
+		buf = response_buf_find(client);
+		if (buf != NULL) {
+			buf->logs.active = false;
+		}
+		return 0;
+	}
+
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+
+	/* A new stream pays its token before it claims a buffer. */
+	buf = response_buf_find(client);
+	if ((buf == NULL) || !buf->logs.active) {
+		if (reject_if_rate_limited(client, response_ctx)) {
+			return 0;
+		}
+
+		buf = response_buf_get(client);
+		if (buf == NULL) {
+			return -ENOMEM;
+		}
+
+		logs = &buf->logs;
+		logs->active = true;
+		logs->end = log_service_write_cursor();
+		if (!api_router_query_param_u32(client->url_buffer, "since", &logs->cursor)) {
+			logs->cursor = log_service_oldest_cursor();
+		}
+
+		snprintk(logs->end_str, sizeof(logs->end_str), "%u", logs->end);
+		logs->headers[0] = (struct http_header){ "Content-Type", "text/plain" };
+		logs->headers[1] = (struct http_header){ "X-Log-Cursor", logs->end_str };
+		response_ctx->headers = logs->headers;
+		response_ctx->header_count = ARRAY_SIZE(logs->headers);
+	}
+
+	logs = &buf->logs;
+
+	len = log_service_read(&logs->cursor, logs->end, buf->data, sizeof(buf->data));
+
+	response_ctx->body = buf->data;
+	response_ctx->body_len = len;
+	response_ctx->final_chunk = (len < sizeof(buf->data));
+	if (response_ctx->final_chunk) {
+		logs->active = false;
+	}
+
+	return 0;
+}
+
+static const struct {
+	const char *name;
+	int (*format)(char *buf, size_t buf_len);
+} net_members[] = {
+	{ "pkt", net_stats_format_pkt },
+	{ "tcp", net_stats_format_tcp },
+	{ "sockets", net_stats_format_sockets },
+};
+
+/*
+ * Report network memory and TCP counters, one JSON member per chunk:
+ * net_pkt slabs, TCP statistics, socket counts, then every net_buf pool.
+ * A value that is unavailable or does not fit its chunk is sent as null,
+ * so the document stays valid JSON.
+ */
+static int api_net_handler(struct http_client_ctx *client, enum http_data_status status,
+			   const struct http_request_ctx *request_ctx,
+			   struct http_response_ctx *response_ctx, void *user_data)
+{
+	struct response_buf *buf;
+	struct net_stream *net;
+	char *out;
+	size_t size;
+	int len;
+	int ret;
+
+	ARG_UNUSED(request_ctx);
+	ARG_UNUSED(user_data);
+
+	if (status == HTTP_SERVER_DATA_ABORTED) {
+		buf = response_buf_find(client);
+		if (buf != NULL) {
+			buf->net.active = false;
+		}
+		return 0;
+	}
+
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+
+	/* A new stream pays its token before it claims a buffer. */
+	buf = response_buf_find(client);
+	if ((buf == NULL) || !buf->net.active) {
+		if (reject_if_rate_limited(client, response_ctx)) {
+			return 0;
+		}
+
+		buf = response_buf_get(client);
+		if (buf == NULL) {
+			return -ENOMEM;
+		}
+
+		buf->net.active = true;
+		buf->net.step = 0U;
+	}
+
+	net = &buf->net;
+
+	out = (char *)buf->data;
+	/* Keep room for the closing "]}" after the last pool. */
+	size = sizeof(buf->data) - 2U;
+
+	response_ctx->final_chunk = false;
+	if (net->step < ARRAY_SIZE(net_members)) {
+		len = snprintk(out, size, "%c\"%s\":", (net->step == 0U) ? '{' : ',',
+			       net_members[net->step].name);
+		ret = net_members[net->step].format(&out[len], size - len);
+	} else {
+		size_t index = net->step - ARRAY_SIZE(net_members);
+
+		len = snprintk(out, size, (index == 0U) ? ",\"buf_pools\":[" : ",");
+		ret = net_stats_format_buf_pool(index, &out[len], size - len);
+		if (ret == -ENOENT) {
+			len = (index == 0U) ? len : 0;
+			len += snprintk(&out[len], sizeof(buf->data) - len, "]}");
+			response_ctx->final_chunk = true;
+			net->active = false;
+		}
+	}
+
+	if (!response_ctx->final_chunk) {
+		if ((ret < 0) || ((size_t)ret >= size - len)) {
+			ret = snprintk(&out[len], size - len, "null");
+		}
+		len += ret;
+	}
+
+	net->step++;
+
+	response_ctx->body = buf->data;
+	response_ctx->body_len = (size_t)len;
+	return 0;
+}
+
+#if defined(CONFIG_APP_METRICS_ARCHIVE)
+#define ARCHIVE_CHUNK_RECORDS 4
+/* Widest renderings, so one chunk can never be truncated. */
+#define ARCHIVE_JSON_HEADER_MAX                                                                \
+	(sizeof("{\"oldest\":4294967295,\"next\":4294967295,\"records\":[") - 1)
+#define ARCHIVE_JSON_RECORD_MAX                                                                \
+	(sizeof(",[4294967295,65535,4294967295,-128,-128,-128,65535]") - 1)
+/* The first chunk can also be the last, so count the header and "]}\0". */
+#define ARCHIVE_JSON_CHUNK_MAX                                                                 \
+	(ARCHIVE_JSON_HEADER_MAX + (ARCHIVE_CHUNK_RECORDS * ARCHIVE_JSON_RECORD_MAX) +        \
+	 sizeof("]}"))
+
+BUILD_ASSERT(CONFIG_APP_STATUS_RESPONSE_BUF_SIZE >= ARCHIVE_JSON_CHUNK_MAX,
+	     "Archive chunks need room for a header, four records and the trailer");
+
+/*
+ * Stream archived samples as JSON, oldest first:
+ * /api/metrics/archive?from=<seq>&count=<n>. Each record is
+ * [seq, boot, uptime_s, cpu_percent, ram_percent, rssi_dbm, wifi_reconnects].
+ */
+
+static int api_metrics_archive_handler(struct http_client_ctx *client,
+				       enum http_data_status status,
+				       const struct http_request_ctx *request_ctx,
+				       struct http_response_ctx *response_ctx, void *user_data)
+{
+	struct metrics_record records[ARCHIVE_CHUNK_RECORDS];
+	struct archive_stream *archive;
+	struct response_buf *buf;
+	size_t count;
+	int len = 0;
+	int ret;
+
+	ARG_UNUSED(request_ctx);
+	ARG_UNUSED(user_data);
+
+	if (status == HTTP_SERVER_DATA_ABORTED) {
+		buf = response_buf_find(client);
+		if (buf != NULL) {
+			buf->archive.active = false;
+		}
+		return 0;
+	}
+
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+
+	/* A new stream pays its token before it claims a buffer. */
+	buf = response_buf_find(client);
+	if ((buf == NULL) || !buf->archive.active) {
+		if (reject_if_rate_limited(client, response_ctx)) {
+			return 0;
+		}
+
+		buf = response_buf_get(client);
+		if (buf == NULL) {
+			return -ENOMEM;
+		}
+
+		archive = &buf->archive;
+		archive->active = true;
+		archive->first = true;
+		if (!api_router_query_param_u32(client->url_buffer, "from", &archive->seq)) {
+			archive->seq = metrics_archive_oldest_seq();
+		}
+		if (!api_router_query_param_u32(client->url_buffer, "count", &archive->remaining)) {
+			archive->remaining = UINT32_MAX;
+		}
+
+		ret = response_append(buf, &len, "{\"oldest\":%u,\"next\":%u,\"records\":[",
+				     metrics_archive_oldest_seq(), metrics_archive_next_seq());
+		if (ret < 0) {
+			archive->active = false;
+			return ret;
+		}
+	}
+
+	archive = &buf->archive;
+	count = metrics_archive_read(&archive->seq, records,
+				     MIN(archive->remaining, ARRAY_SIZE(records)));
+	archive->remaining -= count;
+
+	for (size_t i = 0; i < count; i++) {
+		ret = response_append(buf, &len, "%s[%u,%u,%u,%d,%d,%d,%u]",
+				     archive->first ? "" : ",", records[i].seq,
+				     records[i].boot_count, records[i].uptime_s,
+				     records[i].cpu_percent, records[i].ram_percent,
+				     records[i].rssi_dbm, records[i].wifi_reconnects);
+		if (ret < 0) {
+			archive->active = false;
+			return ret;
+		}
+		archive->first = false;
+	}
+
+	response_ctx->final_chunk = (count == 0U) || (archive->remaining == 0U);
+	if (response_ctx->final_chunk) {
+		archive->active = false;
+		ret = response_append(buf, &len, "]}");
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	response_ctx->body = buf->data;
+	response_ctx->body_len = (size_t)len;
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_APP_OTA)
+/*
+ * /api/ota is its own resource, so the server's holder check already
+ * answers 503 to a second upload and an upload never blocks /api/*.
+ */
+static bool ota_active;
+static int ota_result;
+
+static const struct http_header ota_headers[] = {
+	{ .name = "Content-Type", .value = "application/json" },
+};
+
+static int ota_status_for(int err)
+{
+	switch (err) {
+	case -ENOEXEC:
+	case -EBADMSG:
+	case -EINVAL:
+		return HTTP_400_BAD_REQUEST;
+	case -ENOMEM:
+	case -ENOSPC:
+		return HTTP_413_PAYLOAD_TOO_LARGE;
+	default:
+		return HTTP_500_INTERNAL_SERVER_ERROR;
+	}
+}
+
+/*
+ * Stream a signed MCUboot image into the secondary slot:
+ * POST /api/ota[?sha256=<hex>][&reboot=1]. Body chunks are written as they
+ * arrive, so no copy of the image is held in RAM.
+ */
+static int api_ota_handler(struct http_client_ctx *client, enum http_data_status status,
+			   const struct http_request_ctx *request_ctx,
+			   struct http_response_ctx *response_ctx, void *user_data)
+{
+	uint8_t expected[OTA_SERVICE_SHA256_LEN];
+	uint8_t digest[OTA_SERVICE_SHA256_LEN];
+	char digest_hex[(2 * OTA_SERVICE_SHA256_LEN) + 1];
+	bool have_expected = false;
+	struct response_buf *buf;
+	const char *param;
+	size_t param_len;
+	size_t image_len = 0U;
+	uint32_t reboot = 0U;
+	int ret;
+
+	ARG_UNUSED(user_data);
+
+	if (status == HTTP_SERVER_DATA_ABORTED) {
+		if (ota_active) {
+			ota_service_abort();
+			ota_active = false;
+		}
+		return 0;
+	}
+
+	if (!ota_active) {
+		ota_active = true;
+		ota_result = ota_service_begin();
+	}
+
+	if ((ota_result == 0) && (request_ctx->data_len > 0U)) {
+		ota_result = ota_service_write(request_ctx->data, request_ctx->data_len);
+	}
+
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+
+	ota_active = false;
+	buf = response_buf_get(client);
+	if (buf == NULL) {
+		ota_service_abort();
+		return -ENOMEM;
+	}
+
+	if (api_router_query_param(client->url_buffer, "sha256", &param, &param_len)) {
+		have_expected = (param_len == 2U * sizeof(expected)) &&
+				(hex2bin(param, param_len, expected, sizeof(expected)) ==
+				 sizeof(expected));
+		if (!have_expected && (ota_result == 0)) {
+			ota_service_abort();
+			ota_result = -EINVAL;
+		}
+	}
+
+	if (ota_result == 0) {
+		ota_result = ota_service_finish(have_expected ? expected : NULL, digest,
+						&image_len);
+	}
+
+	response_ctx->headers = ota_headers;
+	response_ctx->header_count = ARRAY_SIZE(ota_headers);
+	response_ctx->final_chunk = true;
+	if (ota_result < 0) {
+		response_ctx->status = ota_status_for(ota_result);
+		ret = snprintk((char *)buf->data, sizeof(buf->data), "{\"error\":%d}", ota_result);
+	} else {
+		(void)bin2hex(digest, sizeof(digest), digest_hex, sizeof(digest_hex));
+		ret = snprintk((char *)buf->data, sizeof(buf->data),
+			       "{\"bytes\":%zu,\"sha256\":\"%s\",\"state\":\"test\"}", image_len,
+			       digest_hex);
+		if (api_router_query_param_u32(client->url_buffer, "reboot", &reboot) &&
+		    (reboot != 0U)) {
+			ota_service_schedule_reboot();
+		}
+	}
+
+	response_ctx->body = buf->data;
+	response_ctx->body_len = MIN((size_t)ret, sizeof(buf->data) - 1);
+	return 0;
+}
+#endif
+
+static struct http_resource_detail_dynamic api_router_detail = {
 	.common = {
 		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
 		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
-		.content_type = "application/json",
 	},
-	.cb = api_status_handler,
+	.cb = api_router_cb,
 	.user_data = NULL,
 };
 
+#if defined(CONFIG_APP_OTA)
+static struct http_resource_detail_dynamic api_ota_detail = {
+	.common = {
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.bitmask_of_supported_http_methods = BIT(HTTP_POST),
+	},
+	.cb = api_ota_handler,
+	.user_data = NULL,
+};
+#endif
+
+API_ROUTE_DEFINE(boot, BIT(HTTP_GET), "application/json", api_boot_handler);
+API_ROUTE_DEFINE(logs, BIT(HTTP_GET), "text/plain", api_logs_handler);
+API_ROUTE_DEFINE(metrics, BIT(HTTP_GET), "application/json", api_metrics_handler);
+#if defined(CONFIG_APP_METRICS_ARCHIVE)
+API_ROUTE_DEFINE(metrics_archive, BIT(HTTP_GET), "application/json", api_metrics_archive_handler);
+#endif
+API_ROUTE_DEFINE(net, BIT(HTTP_GET), "application/json", api_net_handler);
+API_ROUTE_DEFINE(status, BIT(HTTP_GET), "application/json", api_status_handler);
+
 #if defined(CONFIG_APP_WEB_CONTENT_FROM_FILESYSTEM)
-static struct http_resource_detail_static_fs web_fs_detail = {
+static struct http_resource_detail_dynamic web_fs_detail = {
 	.common = {
-		.type = HTTP_RESOURCE_TYPE_STATIC_FS,
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
 		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
 	},
-	.fs_path = FILESYSTEM_WEB_FS_PATH,
+	.cb = asset_handler_cb,
+	.user_data = NULL,
 };
 #else
 static const uint8_t web_index_html[] = {
@@ -102,6 +874,10 @@ static const uint8_t web_app_js[] = {
 #include "web_app_js.inc"
 };
 
+static const uint8_t web_sw_js[] = {
+#include "web_sw_js.inc"
+};
+
 static const uint8_t web_bootstrap_min_css_gz[] = {
 #include "web_bootstrap_min_css_gz.inc"
 };
@@ -110,67 +886,118 @@ static const uint8_t web_bootstrap_bundle_min_js_gz[] = {
 #include "web_bootstrap_bundle_min_js_gz.inc"
 };
 
-static struct http_resource_detail_static web_index_detail = {
+static struct asset_handler_blob web_index_blob = {
+	.data = web_index_html,
+	.len = sizeof(web_index_html),
+};
+
+static struct http_resource_detail_dynamic web_index_detail = {
 	.common = {
-		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
 		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
 		.content_type = "text/html",
 	},
-	.static_data = web_index_html,
-	.static_data_len = sizeof(web_index_html),
+	.cb = asset_handler_cb,
+	.user_data = &web_index_blob,
 };
 
-static struct http_resource_detail_static web_styles_detail = {
+static struct asset_handler_blob web_styles_blob = {
+	.data = web_styles_css,
+	.len = sizeof(web_styles_css),
+};
+
+static struct http_resource_detail_dynamic web_styles_detail = {
 	.common = {
-		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
 		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
 		.content_type = "text/css",
 	},
-	.static_data = web_styles_css,
-	.static_data_len = sizeof(web_styles_css),
+	.cb = asset_handler_cb,
+	.user_data = &web_styles_blob,
+};
+
+static struct asset_handler_blob web_app_js_blob = {
+	.data = web_app_js,
+	.len = sizeof(web_app_js),
+};
+
+static struct http_resource_detail_dynamic web_app_js_detail = {
+	.common = {
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		.content_type = "text/javascript",
+	},
+	.cb = asset_handler_cb,
+	.user_data = &web_app_js_blob,
+};
+
+static struct asset_handler_blob web_sw_js_blob = {
+	.data = web_sw_js,
+	.len = sizeof(web_sw_js),
 };
 
-static struct http_resource_detail_static web_app_js_detail = {
+static struct http_resource_detail_dynamic web_sw_js_detail = {
 	.common = {
-		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
 		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
 		.content_type = "text/javascript",
 	},
-	.static_data = web_app_js,
-	.static_data_len = sizeof(web_app_js),
+	.cb = asset_handler_cb,
+	.user_data = &web_sw_js_blob,
+};
+
+static struct asset_handler_blob web_bootstrap_css_blob = {
+	.data = web_bootstrap_min_css_gz,
+	.len = sizeof(web_bootstrap_min_css_gz),
+	.content_encoding = "gzip",
 };
 
-static struct http_resource_detail_static web_bootstrap_css_detail = {
+static struct http_resource_detail_dynamic web_bootstrap_css_detail = {
 	.common = {
-		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
 		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
 		.content_type = "text/css",
-		.content_encoding = "gzip",
 	},
-	.static_data = web_bootstrap_min_css_gz,
-	.static_data_len = sizeof(web_bootstrap_min_css_gz),
+	.cb = asset_handler_cb,
+	.user_data = &web_bootstrap_css_blob,
 };
 
-static struct http_resource_detail_static web_bootstrap_js_detail = {
+static struct asset_handler_blob web_bootstrap_js_blob = {
+	.data = web_bootstrap_bundle_min_js_gz,
+	.len = sizeof(web_bootstrap_bundle_min_js_gz),
+	.content_encoding = "gzip",
+};
+
+static struct http_resource_detail_dynamic web_bootstrap_js_detail = {
 	.common = {
-		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
 		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
 		.content_type = "text/javascript",
-		.content_encoding = "gzip",
 	},
-	.static_data = web_bootstrap_bundle_min_js_gz,
-	.static_data_len = sizeof(web_bootstrap_bundle_min_js_gz),
+	.cb = asset_handler_cb,
+	.user_data = &web_bootstrap_js_blob,
 };
 #endif
 
 HTTP_SERVICE_DEFINE(web_http_service, NULL, &http_port, 4, 8, NULL, NULL, NULL);
-HTTP_RESOURCE_DEFINE(api_status_resource, web_http_service, "/api/status", &api_status_detail);
+#if defined(CONFIG_APP_OTA)
+/*
+ * A dynamic resource serves one client at a time, so a long upload through
+ * the router would answer every other /api/* request with 503. Defined
+ * first (resources are sorted by name) so it wins over API_ROUTER_PREFIX "*".
+ */
+HTTP_RESOURCE_DEFINE(api_ota_resource, web_http_service, API_ROUTER_PREFIX "ota",
+		     &api_ota_detail);
+#endif
+HTTP_RESOURCE_DEFINE(api_router_resource, web_http_service, API_ROUTER_PREFIX "*",
+		     &api_router_detail);
 #if defined(CONFIG_APP_WEB_CONTENT_FROM_FILESYSTEM)
 HTTP_RESOURCE_DEFINE(web_fs_resource, web_http_service, "/*", &web_fs_detail);
 #else
 HTTP_RESOURCE_DEFINE(web_index_resource, web_http_service, "/", &web_index_detail);
 HTTP_RESOURCE_DEFINE(web_styles_resource, web_http_service, "/styles.css", &web_styles_detail);
 HTTP_RESOURCE_DEFINE(web_app_js_resource, web_http_service, "/app.js", &web_app_js_detail);
+HTTP_RESOURCE_DEFINE(web_sw_js_resource, web_http_service, "/sw.js", &web_sw_js_detail);
 HTTP_RESOURCE_DEFINE(web_bootstrap_css_resource, web_http_service,
 		     "/vendor/bootstrap/css/bootstrap.min.css", &web_bootstrap_css_detail);
 HTTP_RESOURCE_DEFINE(web_bootstrap_js_resource, web_http_service,
@@ -184,10 +1011,16 @@ int webserver_service_init(const struct webserver_status_provider *provider)
 	}
 
 	status_provider = *provider;
+	asset_handler_init();
+	for (size_t i = 0; i < ARRAY_SIZE(status_snapshots); i++) {
+		(void)status_json_init(status_snapshots[i].json, sizeof(status_snapshots[i].json));
+	}
+	status_snapshot_refresh();
 	return 0;
 }
 
 int webserver_service_start(void)
 {
+	(void)k_work_schedule(&status_snapshot_work, K_MSEC(CONFIG_APP_STATUS_SNAPSHOT_PERIOD_MS));
 	return http_server_start();
 }
@@ -12,7 +12,9 @@
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/net_mgmt.h>
 #include <zephyr/net/wifi_mgmt.h>
+#include <zephyr/sys/atomic.h>
 
+#include "boot_timeline.h"
 #include "wifi_secrets.h"
 
 LOG_MODULE_REGISTER(wifi_service, LOG_LEVEL_INF);
@@ -24,6 +26,7 @@ static int wifi_connect_result = -EAGAIN;
 static bool reconnect_requested;
 static bool wifi_ready;
 static int64_t last_reconnect_attempt;
+static atomic_t reconnect_count;
 static struct wifi_connect_req_params wifi_params;
 
 K_SEM_DEFINE(wifi_connected_sem, 0, 1);
@@ -54,6 +57,29 @@ const char *wifi_service_get_ssid(void)
 	return WIFI_SSID;
 }
 
+int wifi_service_get_rssi(int *rssi_dbm)
+{
+	struct wifi_iface_status status = { 0 };
+	int ret;
+
+	if ((wifi_iface == NULL) || !wifi_ready) {
+		return -ENOTCONN;
+	}
+
+	ret = net_mgmt(NET_REQUEST_WIFI_IFACE_STATUS, wifi_iface, &status, sizeof(status));
+	if (ret < 0) {
+		return ret;
+	}
+
+	*rssi_dbm = status.rssi;
+	return 0;
+}
+
+uint32_t wifi_service_get_reconnect_count(void)
+{
+	return (uint32_t)atomic_get(&reconnect_count);
+}
+
 static void wifi_mgmt_handler(struct net_mgmt_event_callback *cb, uint64_t mgmt_event,
 			      struct net_if *iface)
 {
@@ -156,6 +182,11 @@ static int connect_to_wifi(void)
 	}
 
 	for (attempt = 1; attempt <= 5; attempt++) {
+		/*
+		 * Each attempt restarts the span, so it covers the attempt that
+		 * associated and not the retry backoff before it.
+		 */
+		boot_timeline_begin(BOOT_PHASE_WIFI_ASSOC);
 		wifi_connect_result = -EAGAIN;
 		wifi_ready = false;
 		k_sem_reset(&wifi_connected_sem);
@@ -171,6 +202,7 @@ static int connect_to_wifi(void)
 		if (wifi_service_get_ipv4_addr((char[NET_IPV4_ADDR_LEN]){0}, NET_IPV4_ADDR_LEN) == 0) {
 			wifi_connect_result = 0;
 			wifi_ready = true;
+			boot_timeline_end(BOOT_PHASE_WIFI_ASSOC);
 			return 0;
 		}
 
@@ -187,17 +219,27 @@ static int connect_to_wifi(void)
 			continue;
 		}
 
+		boot_timeline_end(BOOT_PHASE_WIFI_ASSOC);
+		boot_timeline_begin(BOOT_PHASE_DHCP);
+
 		LOG_INF("Waiting for DHCP IPv4 lease");
 		ret = k_sem_take(&ipv4_addr_sem, K_SECONDS(30));
 		if (ret == 0 && wifi_ready) {
+			boot_timeline_end(BOOT_PHASE_DHCP);
 			return 0;
 		}
 
 		if (wifi_service_get_ipv4_addr((char[NET_IPV4_ADDR_LEN]){0}, NET_IPV4_ADDR_LEN) == 0) {
 			wifi_ready = true;
+			boot_timeline_end(BOOT_PHASE_DHCP);
 			return 0;
 		}
 
+		/*
+		 * Close the DHCP span before the next attempt reassociates, so the
+		 * timeline never has both phases open. A later lease restarts it.
+		 */
+		boot_timeline_end(BOOT_PHASE_DHCP);
 		LOG_ERR("Timed out waiting for IPv4 address");
 		k_sleep(K_SECONDS(2));
 	}
@@ -257,6 +299,7 @@ void wifi_service_process(void)
 	}
 
 	LOG_INF("Attempting Wi-Fi reconnect");
+	(void)atomic_inc(&reconnect_count);
 	(void)request_wifi_connect();
 	last_reconnect_attempt = now_ms;
 }
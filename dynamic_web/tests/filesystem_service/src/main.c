@@ -0,0 +1,95 @@
+#include <zephyr/fs/fs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+
+#include "filesystem_service.h"
+
+static void erase_storage(void)
+{
+	const struct flash_area *fa;
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(storage_partition), &fa));
+	zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+	flash_area_close(fa);
+}
+
+static void assert_within_budget(const char *what, uint32_t us, uint32_t budget_ms)
+{
+	/* Zero means the clock did not advance and the budget proves nothing. */
+	zassert_true(us > 0U, "%s took no measurable time", what);
+
+	if (budget_ms > 0U) {
+		zassert_true(us <= budget_ms * USEC_PER_MSEC, "%s took %u us, budget is %u ms",
+			     what, us, budget_ms);
+	}
+}
+
+ZTEST(filesystem_service, test_format_fallback)
+{
+	struct filesystem_service_timing timing;
+
+	erase_storage();
+
+	zassert_ok(filesystem_service_mount_or_format());
+	filesystem_service_get_timing(&timing);
+	zassert_true(timing.formatted, "Blank partition was mounted without a format");
+}
+
+ZTEST(filesystem_service, test_mount_within_budget)
+{
+	struct filesystem_service_timing timing;
+
+	/* Make sure a filesystem exists, then time a plain mount of it. */
+	zassert_ok(filesystem_service_mount_or_format());
+	zassert_ok(filesystem_service_unmount());
+
+	zassert_ok(filesystem_service_mount_or_format());
+	filesystem_service_get_timing(&timing);
+	zassert_false(timing.formatted, "Existing filesystem was reformatted");
+	assert_within_budget("Mount", timing.mount_us, CONFIG_APP_FS_MOUNT_BUDGET_MS);
+}
+
+ZTEST(filesystem_service, test_sync_within_budget)
+{
+	struct filesystem_service_timing timing;
+	struct fs_dirent entry;
+
+	zassert_ok(filesystem_service_mount_or_format());
+	zassert_ok(filesystem_service_sync_web_assets());
+	filesystem_service_get_timing(&timing);
+	assert_within_budget("Web asset sync", timing.sync_us, CONFIG_APP_FS_SYNC_BUDGET_MS);
+
+	zassert_ok(fs_stat(FILESYSTEM_WEB_FS_PATH "/index.html", &entry));
+	zassert_equal(entry.type, FS_DIR_ENTRY_FILE);
+	zassert_true(entry.size > 0U);
+	zassert_ok(fs_stat(FILESYSTEM_WEB_FS_PATH "/vendor/bootstrap/js/bootstrap.bundle.min.js.gz",
+			   &entry));
+}
+
+ZTEST(filesystem_service, test_sync_again_after_remount)
+{
+	struct filesystem_service_timing timing;
+
+	zassert_ok(filesystem_service_mount_or_format());
+	zassert_ok(filesystem_service_sync_web_assets());
+	zassert_ok(filesystem_service_unmount());
+
+	/* Overwriting existing files is the common boot path. */
+	zassert_ok(filesystem_service_mount_or_format());
+	filesystem_service_get_timing(&timing);
+	zassert_false(timing.formatted);
+	zassert_ok(filesystem_service_sync_web_assets());
+	filesystem_service_get_timing(&timing);
+	assert_within_budget("Web asset resync", timing.sync_us, CONFIG_APP_FS_SYNC_BUDGET_MS);
+}
+
+/* Every case starts unmounted; unmounting when nothing is mounted just fails. */
+static void filesystem_service_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)filesystem_service_unmount();
+}
+
+ZTEST_SUITE(filesystem_service, NULL, NULL, filesystem_service_before, NULL, NULL);
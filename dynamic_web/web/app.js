@@ -24,20 +24,39 @@ function updateLoadBar(percent, barId, labelId) {
   }
 }
 
+let statusVersion = null;
+let uptimeMs = 0;
+let uptimeAt = 0;
+
+function showUptime() {
+  document.getElementById('uptime').textContent = formatUptime(uptimeMs + (Date.now() - uptimeAt));
+}
+
 async function refreshStatus() {
   try {
-    const response = await fetch('/api/status', { cache: 'no-store' });
+    const url = statusVersion === null ? '/api/status' : `/api/status?since=${statusVersion}`;
+    const response = await fetch(url, { cache: 'no-store' });
     if (!response.ok) {
       throw new Error(`HTTP ${response.status}`);
     }
 
-    const data = await response.json();
+    /* An empty body means nothing but uptime changed since statusVersion. */
+    const text = await response.text();
+    if (text === '') {
+      showUptime();
+      return true;
+    }
+
+    const data = JSON.parse(text);
+    statusVersion = Number(data.version ?? 0);
     const cpuLoad = Number(data.cpu_load_percent ?? -1);
     const ramLoad = Number(data.ram_util_percent ?? -1);
 
     document.getElementById('ip').textContent = data.ip ?? '-';
     document.getElementById('ssid').textContent = data.ssid ?? '-';
-    document.getElementById('uptime').textContent = formatUptime(Number(data.uptime_ms ?? 0));
+    uptimeMs = Number(data.uptime_ms ?? 0);
+    uptimeAt = Date.now();
+    showUptime();
     updateLoadBar(cpuLoad, 'cpu-load-bar', 'cpu-load-label');
     updateLoadBar(ramLoad, 'ram-load-bar', 'ram-load-label');
   } catch (error) {
@@ -46,8 +65,25 @@ async function refreshStatus() {
     document.getElementById('uptime').textContent = error.message;
     updateLoadBar(-1, 'cpu-load-bar', 'cpu-load-label');
     updateLoadBar(-1, 'ram-load-bar', 'ram-load-label');
+    statusVersion = null;
+    return false;
   }
+
+  return true;
 }
 
-refreshStatus();
-setInterval(refreshStatus, 2000);
+/* The device answers at once; polls that find no change cost an empty response. */
+const STATUS_POLL_MS = 2000;
+
+async function pollStatus() {
+  const ok = await refreshStatus();
+  setTimeout(pollStatus, ok ? STATUS_POLL_MS : 2 * STATUS_POLL_MS);
+}
+
+pollStatus();
+
+if ('serviceWorker' in navigator) {
+  navigator.serviceWorker.register('/sw.js').catch((error) => {
+    console.warn('Service worker registration failed:', error);
+  });
+}
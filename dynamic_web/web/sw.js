@@ -0,0 +1,46 @@
+/* Bump SHELL_VERSION whenever any file in SHELL_ASSETS changes. */
+const SHELL_VERSION = 'v3';
+const SHELL_CACHE = `dynamic-web-shell-${SHELL_VERSION}`;
+const SHELL_ASSETS = [
+  '/',
+  '/styles.css',
+  '/app.js',
+  '/vendor/bootstrap/css/bootstrap.min.css',
+  '/vendor/bootstrap/js/bootstrap.bundle.min.js',
+];
+
+self.addEventListener('install', (event) => {
+  event.waitUntil(
+    caches.open(SHELL_CACHE)
+      .then((cache) => cache.addAll(SHELL_ASSETS))
+      .then(() => self.skipWaiting())
+  );
+});
+
+self.addEventListener('activate', (event) => {
+  event.waitUntil(
+    caches.keys()
+      .then((keys) => Promise.all(keys
+        .filter((key) => key.startsWith('dynamic-web-shell-') && key !== SHELL_CACHE)
+        .map((key) => caches.delete(key))))
+      .then(() => self.clients.claim())
+  );
+});
+
+self.addEventListener('fetch', (event) => {
+  const url = new URL(event.request.url);
+
+  if (event.request.method !== 'GET' || url.origin !== self.location.origin) {
+    return;
+  }
+
+  /* Live data always goes to the device. */
+  if (url.pathname.startsWith('/api/')) {
+    return;
+  }
+
+  event.respondWith(
+    caches.match(event.request, { ignoreSearch: true })
+      .then((cached) => cached ?? fetch(event.request))
+  );
+});
@@ -0,0 +1,162 @@
+#include "frame_stats.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <lvgl.h>
+
+LOG_MODULE_REGISTER(frame_stats, LOG_LEVEL_INF);
+
+/* Bucket 0 is < 1 us, bucket b holds [2^(b-1), 2^b) us, the last is open. */
+#define FRAME_STATS_BUCKETS 18
+
+struct frame_histogram {
+	uint32_t buckets[FRAME_STATS_BUCKETS];
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+};
+
+static const char *const stat_names[FRAME_STAT_COUNT] = {
+	[FRAME_STAT_TICK] = "tick",
+	[FRAME_STAT_TIMER_HANDLER] = "lv_timer_handler",
+	[FRAME_STAT_REFRESH] = "refresh",
+	[FRAME_STAT_FLUSH] = "flush",
+};
+
+/*
+ * Game tick, LVGL timers and display events all run in the main thread, so
+ * the histograms need no locking.
+ */
+static struct frame_histogram histograms[FRAME_STAT_COUNT];
+static timing_t refresh_start;
+static timing_t flush_start;
+static uint64_t flush_cycles;
+static uint32_t flush_count;
+
+static uint32_t cycles_to_us(uint64_t cycles)
+{
+	return (uint32_t)(timing_cycles_to_ns(cycles) / NSEC_PER_USEC);
+}
+
+static void record_us(enum frame_stat stat, uint32_t us)
+{
+	struct frame_histogram *hist = &histograms[stat];
+	int bucket = (us == 0U) ? 0 : MIN(32 - __builtin_clz(us), FRAME_STATS_BUCKETS - 1);
+
+	hist->buckets[bucket]++;
+	hist->min_us = (hist->count == 0U) ? us : MIN(hist->min_us, us);
+	hist->max_us = MAX(hist->max_us, us);
+	hist->total_us += us;
+	hist->count++;
+}
+
+void frame_stats_stop(enum frame_stat stat, timing_t start)
+{
+	timing_t end = timing_counter_get();
+
+	record_us(stat, cycles_to_us(timing_cycles_get(&start, &end)));
+}
+
+/* Upper bound in us of the bucket holding the given percentile. */
+static uint32_t percentile_us(const struct frame_histogram *hist, uint32_t pct)
+{
+	uint32_t rank = DIV_ROUND_UP(hist->count * pct, 100U);
+	uint32_t seen = 0U;
+
+	for (int b = 0; b < FRAME_STATS_BUCKETS - 1; b++) {
+		seen += hist->buckets[b];
+		if (seen >= rank) {
+			return BIT(b);
+		}
+	}
+
+	return hist->max_us;
+}
+
+static void report_cb(lv_timer_t *timer)
+{
+	char line[FRAME_STATS_BUCKETS * 14];
+
+	ARG_UNUSED(timer);
+
+	for (int i = 0; i < FRAME_STAT_COUNT; i++) {
+		struct frame_histogram *hist = &histograms[i];
+		size_t len = 0U;
+
+		if (hist->count == 0U) {
+			continue;
+		}
+
+		for (int b = 0; b < FRAME_STATS_BUCKETS; b++) {
+			if (hist->buckets[b] == 0U) {
+				continue;
+			}
+
+			len += snprintk(&line[len], sizeof(line) - len, " %s%lu:%u",
+					(b == FRAME_STATS_BUCKETS - 1) ? ">=" : "<",
+					(b == FRAME_STATS_BUCKETS - 1) ? BIT(b - 1) : BIT(b),
+					hist->buckets[b]);
+			if (len >= sizeof(line)) {
+				break;
+			}
+		}
+
+		LOG_INF("%s: n=%u min=%u avg=%u max=%u us, p50<=%u p95<=%u p99<=%u us",
+			stat_names[i], hist->count, hist->min_us,
+			(uint32_t)(hist->total_us / hist->count), hist->max_us,
+			percentile_us(hist, 50U), percentile_us(hist, 95U),
+			percentile_us(hist, 99U));
+		LOG_INF("%s us:%s", stat_names[i], line);
+	}
+
+	/* Each report covers one period so drift shows up over time. */
+	memset(histograms, 0, sizeof(histograms));
+}
+
+static void display_event_cb(lv_event_t *event)
+{
+	timing_t now = timing_counter_get();
+
+	switch (lv_event_get_code(event)) {
+	case LV_EVENT_REFR_START:
+		refresh_start = now;
+		flush_cycles = 0U;
+		flush_count = 0U;
+		break;
+	case LV_EVENT_FLUSH_START:
+		flush_start = now;
+		break;
+	case LV_EVENT_FLUSH_FINISH:
+		flush_cycles += timing_cycles_get(&flush_start, &now);
+		flush_count++;
+		break;
+	case LV_EVENT_REFR_READY:
+		/* Refreshes with nothing invalidated do not count as frames. */
+		if (flush_count > 0U) {
+			record_us(FRAME_STAT_REFRESH,
+				  cycles_to_us(timing_cycles_get(&refresh_start, &now)));
+			record_us(FRAME_STAT_FLUSH, cycles_to_us(flush_cycles));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void frame_stats_init(void)
+{
+	lv_display_t *display = lv_display_get_default();
+
+	timing_init();
+	timing_start();
+
+	if (display != NULL) {
+		lv_display_add_event_cb(display, display_event_cb, LV_EVENT_ALL, NULL);
+	}
+
+	lv_timer_create(report_cb, CONFIG_APP_SNAKE_FRAME_STATS_REPORT_S * MSEC_PER_SEC, NULL);
+}
@@ -0,0 +1,51 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <stdint.h>
+
+#include <zephyr/timing/timing.h>
+
+enum frame_stat {
+	/* Game logic in the tick timer callback. */
+	FRAME_STAT_TICK,
+	/* One lv_timer_handler() call from the main loop. */
+	FRAME_STAT_TIMER_HANDLER,
+	/* LVGL refresh of one frame: render plus flush. */
+	FRAME_STAT_REFRESH,
+	/* Display flush callbacks within one refresh. */
+	FRAME_STAT_FLUSH,
+	FRAME_STAT_COUNT,
+};
+
+#if defined(CONFIG_APP_SNAKE_FRAME_STATS)
+/*
+ * Start the cycle counter, hook the display refresh and flush events and
+ * start the periodic histogram report. Call after the display is created.
+ */
+void frame_stats_init(void);
+
+static inline timing_t frame_stats_start(void)
+{
+	return timing_counter_get();
+}
+
+/* Add the time since start to the histogram of stat. */
+void frame_stats_stop(enum frame_stat stat, timing_t start);
+#else
+static inline void frame_stats_init(void)
+{
+}
+
+static inline timing_t frame_stats_start(void)
+{
+	return 0;
+}
+
+static inline void frame_stats_stop(enum frame_stat stat, timing_t start)
+{
+	(void)stat;
+	(void)start;
+}
+#endif
+
+#endif
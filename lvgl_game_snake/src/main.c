@@ -6,6 +6,12 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/util.h>
 #include <lvgl.h>
+#include <lvgl_mem.h>
+#include <errno.h>
+
+#include "frame_stats.h"
+#include "snake_autopilot.h"
+#include "snake_engine.h"
 
 // Use the board's pwm-leds backlight node directly.
 #define BACKLIGHT_NODE DT_NODELABEL(pwm_lcd0)
@@ -15,144 +21,562 @@ static const struct pwm_dt_spec backlight =
 
 LOG_MODULE_REGISTER(lvgl_game_snake, LOG_LEVEL_INF);
 
-#define GRID_SIZE 20
-#define MAX_SNAKE_LEN 100
 #define TICK_MS 200
 #define GRID_LINE_COLOR_HEX 0x000000//0x2c3e50
-
-struct cell_pos {
-	int x;
-	int y;
-};
-
-static struct cell_pos snake[MAX_SNAKE_LEN];
-static int snake_len;
-static int dir_x;
-static int dir_y;
-static int pending_dir_x;
-static int pending_dir_y;
-static bool pending_dir;
-static struct cell_pos food;
+#define BOARD_BG_COLOR_HEX 0x111111
+#define SNAKE_COLOR_HEX 0x2ecc71
+#define FOOD_COLOR_HEX 0xe74c3c
+#define MAGIC_FOOD_COLOR_HEX 0xf1c40f
+/* Rules and board state; the UI below only renders it and feeds turns. */
+static struct snake_engine game;
+/*
+ * Turns waiting for a tick, oldest first. Each tick applies one, so quick
+ * successive touches land on consecutive ticks instead of overwriting
+ * each other.
+ */
+static enum snake_dir dir_queue[CONFIG_APP_SNAKE_INPUT_QUEUE_LEN];
+static int dir_queue_head;
+static int dir_queue_count;
+static struct snake_input game_inputs[CONFIG_APP_SNAKE_INPUT_LOG_LEN];
+static struct snake_input_log game_log;
+
+#if defined(CONFIG_APP_SNAKE_AUTOPILOT)
+/* Soak statistics since boot, reported by soak_report_cb(). */
+static uint32_t soak_rounds;
+static int soak_longest;
+#endif
+/* Square board, sized from the display resolution in setup_ui(). */
+static int grid_size;
 static int cell_size;
 static int origin_x;
 static int origin_y;
-static int score;
-static bool food_magic;
-static int food_bonus;
 
-static lv_obj_t *segments[MAX_SNAKE_LEN];
-static lv_obj_t *food_obj;
 static lv_obj_t *score_label;
-static lv_obj_t *grid_border;
 static lv_obj_t *touch_layer;
 static lv_obj_t *legend_box;
 static lv_obj_t *legend_red;
 static lv_obj_t *legend_yellow;
 static lv_obj_t *legend_red_label;
 static lv_obj_t *legend_yellow_label;
-static lv_obj_t *grid_lines[(GRID_SIZE + 1) * 2];
-static lv_point_t grid_line_points[(GRID_SIZE + 1) * 2][2];
 
-static uint32_t rand_state;
+#if defined(CONFIG_APP_SNAKE_RENDER_OBJECTS)
+/*
+ * One entry per body slot, i.e. per board cell. Objects are created the
+ * first time the snake grows into a slot and reused after that.
+ */
+static lv_obj_t **segments;
+static lv_obj_t *food_obj;
+static lv_obj_t *grid_border;
+#else
+/* Grid, snake and food are all painted by board_draw_cb() on this object. */
+static lv_obj_t *board_obj;
+static struct snake_cell drawn_food;
+#endif
+
+#if defined(CONFIG_APP_SNAKE_SMOOTH_MOTION)
+/* Progress through a tick in 1/256 of a cell. */
+#define MOTION_ONE 256U
+
+/*
+ * Between ticks the new head cell fills in from the neck side and the
+ * vacated tail cell empties towards the new tail, driven by
+ * motion_frame_cb() at display rate.
+ */
+struct board_motion {
+	struct snake_cell head;
+	/* Edge of the head cell facing the neck. */
+	enum snake_dir head_edge;
+	struct snake_cell tail;
+	/* Edge of the old tail cell facing the new tail. */
+	enum snake_dir tail_edge;
+	bool tail_active;
+	uint32_t start_ms;
+	uint32_t q8;
+};
+
+static struct board_motion motion = { .q8 = MOTION_ONE };
+#endif
+
+/*
+ * One grid cell with its top/left lines, pre-blended into RGB565 at setup.
+ * The board tiles it as its background image, so redrawing a cell copies
+ * pixels instead of rasterizing and alpha-blending the grid lines.
+ */
+static lv_draw_buf_t *grid_tile;
+
+static int cell_draw_size(void)
+{
+	return (cell_size > 1) ? (cell_size - 1) : 1;
+}
 
-static uint32_t prng_next(void)
+static lv_color_t food_color(void)
 {
-	rand_state ^= rand_state << 13;
-	rand_state ^= rand_state >> 17;
-	rand_state ^= rand_state << 5;
-	return rand_state;
+	return lv_color_hex(game.food_magic ? MAGIC_FOOD_COLOR_HEX : FOOD_COLOR_HEX);
 }
 
-static bool snake_contains(int x, int y)
+static void grid_tile_create(lv_obj_t *screen, int border_w)
 {
-	for (int i = 0; i < snake_len; i++) {
-		if (snake[i].x == x && snake[i].y == y) {
-			return true;
+	lv_color_t bg = lv_color_mix(lv_color_hex(BOARD_BG_COLOR_HEX),
+				     lv_obj_get_style_bg_color(screen, LV_PART_MAIN), LV_OPA_20);
+	uint16_t bg_px = lv_color_to_u16(bg);
+	uint16_t line_px = lv_color_to_u16(lv_color_mix(lv_color_hex(GRID_LINE_COLOR_HEX), bg,
+							LV_OPA_40));
+	/* Tiling starts at the board's corner, one border width before line 0. */
+	int line = border_w % cell_size;
+
+	grid_tile = lv_draw_buf_create(cell_size, cell_size, LV_COLOR_FORMAT_RGB565,
+				       LV_STRIDE_AUTO);
+	if (grid_tile == NULL) {
+		LOG_WRN("No memory for grid tile, drawing board without lines");
+		return;
+	}
+
+	for (int y = 0; y < cell_size; y++) {
+		uint16_t *row = (uint16_t *)(grid_tile->data + y * grid_tile->header.stride);
+
+		for (int x = 0; x < cell_size; x++) {
+			row[x] = ((x == line) || (y == line)) ? line_px : bg_px;
 		}
 	}
+}
 
-	return false;
+static void board_style(lv_obj_t *board)
+{
+	lv_obj_clear_flag(board, LV_OBJ_FLAG_SCROLLABLE);
+	lv_obj_set_style_radius(board, 0, 0);
+	lv_obj_set_style_pad_all(board, 0, 0);
+	lv_obj_set_style_border_width(board, 0, 0);
+
+	if (grid_tile == NULL) {
+		lv_obj_set_style_bg_color(board, lv_color_hex(BOARD_BG_COLOR_HEX), 0);
+		lv_obj_set_style_bg_opa(board, LV_OPA_20, 0);
+		return;
+	}
+
+	/* The tile already holds the blended background colour. */
+	lv_obj_set_style_bg_opa(board, LV_OPA_TRANSP, 0);
+	lv_obj_set_style_bg_image_src(board, grid_tile, 0);
+	lv_obj_set_style_bg_image_tiled(board, true, 0);
+}
+
+#if defined(CONFIG_APP_SNAKE_RENDER_OBJECTS)
+static lv_obj_t *segment_create(void)
+{
+	lv_obj_t *segment = lv_obj_create(lv_scr_act());
+
+	/* Created after the touch layer, so let presses fall through. */
+	lv_obj_clear_flag(segment, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+	lv_obj_set_size(segment, cell_draw_size(), cell_draw_size());
+	lv_obj_set_style_radius(segment, 0, 0);
+	lv_obj_set_style_border_width(segment, 0, 0);
+	lv_obj_set_style_bg_color(segment, lv_color_hex(SNAKE_COLOR_HEX), 0);
+	return segment;
+}
+
+static int board_create(lv_obj_t *screen, int border_w, lv_coord_t grid_px)
+{
+	int draw = cell_draw_size();
+
+	segments = lv_malloc_zeroed(game.cells * sizeof(segments[0]));
+	if (segments == NULL) {
+		return -ENOMEM;
+	}
+
+	grid_border = lv_obj_create(screen);
+	lv_obj_set_pos(grid_border, origin_x - border_w, origin_y - border_w);
+	lv_obj_set_size(grid_border, grid_px, grid_px);
+	board_style(grid_border);
+
+	food_obj = lv_obj_create(screen);
+	lv_obj_clear_flag(food_obj, LV_OBJ_FLAG_SCROLLABLE);
+	lv_obj_set_size(food_obj, draw, draw);
+	lv_obj_set_style_radius(food_obj, 0, 0);
+	lv_obj_set_style_border_width(food_obj, 0, 0);
+	lv_obj_set_style_bg_color(food_obj, lv_color_hex(FOOD_COLOR_HEX), 0);
+	return 0;
+}
+
+static void board_show_segment(int slot)
+{
+	struct snake_cell cell = snake_engine_cell(&game, slot);
+
+	if (segments[slot] == NULL) {
+		segments[slot] = segment_create();
+	}
+
+	lv_obj_set_pos(segments[slot],
+			   origin_x + cell.x * cell_size,
+			   origin_y + cell.y * cell_size);
+	lv_obj_clear_flag(segments[slot], LV_OBJ_FLAG_HIDDEN);
+}
+
+static void board_hide_segment(int slot, struct snake_cell cell)
+{
+	ARG_UNUSED(cell);
+
+	lv_obj_add_flag(segments[slot], LV_OBJ_FLAG_HIDDEN);
+}
+
+static void board_update_food(void)
+{
+	if (game.food.x < 0) {
+		lv_obj_add_flag(food_obj, LV_OBJ_FLAG_HIDDEN);
+		return;
+	}
+
+	lv_obj_clear_flag(food_obj, LV_OBJ_FLAG_HIDDEN);
+	lv_obj_set_pos(food_obj,
+			 origin_x + game.food.x * cell_size,
+			 origin_y + game.food.y * cell_size);
+	lv_obj_set_style_bg_color(food_obj, food_color(), 0);
 }
 
-static void place_food(void)
+static void board_redraw(void)
+{
+	for (int slot = 0; slot < game.cells; slot++) {
+		if (segments[slot] != NULL) {
+			lv_obj_add_flag(segments[slot], LV_OBJ_FLAG_HIDDEN);
+		}
+	}
+
+	for (int i = 0; i < game.len; i++) {
+		board_show_segment(snake_engine_slot(&game, i));
+	}
+
+	board_update_food();
+}
+#else
+static void cell_area(int x, int y, lv_area_t *area)
 {
-	if (snake_len >= (GRID_SIZE * GRID_SIZE)) {
+	area->x1 = origin_x + x * cell_size;
+	area->y1 = origin_y + y * cell_size;
+	area->x2 = area->x1 + cell_draw_size() - 1;
+	area->y2 = area->y1 + cell_draw_size() - 1;
+}
+
+static void invalidate_cell(int x, int y)
+{
+	lv_area_t area;
+
+	if (x < 0) {
 		return;
 	}
 
-	/* 1 in 6 chance for magic food. */
-	food_magic = ((prng_next() % 6U) == 0U);
-	food_bonus = food_magic ? (int)(1 + (prng_next() % 3U)) : 1;
+	/* Include the grid line on the cell's top/left edge. */
+	cell_area(x, y, &area);
+	area.x2 = area.x1 + cell_size - 1;
+	area.y2 = area.y1 + cell_size - 1;
+	lv_obj_invalidate_area(board_obj, &area);
+}
+
+/* Map a pixel range onto the grid cells it touches, clamped to the board. */
+static bool clip_to_cells(int32_t p1, int32_t p2, int origin, int *c1, int *c2)
+{
+	if ((p2 < origin) || (p1 >= origin + grid_size * cell_size)) {
+		return false;
+	}
+
+	*c1 = (p1 <= origin) ? 0 : (int)((p1 - origin) / cell_size);
+	*c2 = MIN((int)((p2 - origin) / cell_size), grid_size - 1);
+	return true;
+}
+
+#if defined(CONFIG_APP_SNAKE_SMOOTH_MOTION)
+static enum snake_dir dir_between(struct snake_cell from, struct snake_cell to)
+{
+	if (to.x != from.x) {
+		return (to.x > from.x) ? SNAKE_DIR_RIGHT : SNAKE_DIR_LEFT;
+	}
+
+	return (to.y > from.y) ? SNAKE_DIR_DOWN : SNAKE_DIR_UP;
+}
+
+/* Pixels of a cell covered at progress q8. */
+static int motion_px(uint32_t q8)
+{
+	return (int)(((uint32_t)cell_draw_size() * q8) / MOTION_ONE);
+}
+
+/*
+ * Pixels [from, to) of a cell's draw area, counted inwards from the edge
+ * facing its neighbour in direction edge.
+ */
+static void cell_strip(struct snake_cell cell, enum snake_dir edge, int from, int to,
+		       lv_area_t *area)
+{
+	cell_area(cell.x, cell.y, area);
+
+	switch (edge) {
+	case SNAKE_DIR_LEFT:
+		area->x2 = area->x1 + to - 1;
+		area->x1 += from;
+		break;
+	case SNAKE_DIR_RIGHT:
+		area->x1 = area->x2 - to + 1;
+		area->x2 -= from;
+		break;
+	case SNAKE_DIR_UP:
+		area->y2 = area->y1 + to - 1;
+		area->y1 += from;
+		break;
+	default:
+		area->y1 = area->y2 - to + 1;
+		area->y2 -= from;
+		break;
+	}
+}
+
+static bool area_visible(const lv_area_t *area, const lv_area_t *clip)
+{
+	return (area->x1 <= area->x2) && (area->y1 <= area->y2) && (area->x2 >= clip->x1) &&
+	       (area->x1 <= clip->x2) && (area->y2 >= clip->y1) && (area->y1 <= clip->y2);
+}
 
-	for (;;) {
-		/* Keep food away from the outermost grid border (1..GRID_SIZE-2). */
-		int x = 1 + (int)(prng_next() % (GRID_SIZE - 2));
-		int y = 1 + (int)(prng_next() % (GRID_SIZE - 2));
+static void invalidate_strip(struct snake_cell cell, enum snake_dir edge, int from, int to)
+{
+	lv_area_t area;
+
+	if (from < to) {
+		cell_strip(cell, edge, from, to, &area);
+		lv_obj_invalidate_area(board_obj, &area);
+	}
+}
 
-		if (!snake_contains(x, y)) {
-			food.x = x;
-			food.y = y;
-			break;
+/* The sliding head is drawn as a strip, not as a full occupied cell. */
+static bool motion_covers(int x, int y)
+{
+	return (motion.q8 < MOTION_ONE) && (motion.head.x == x) && (motion.head.y == y);
+}
+
+static void board_motion_start(const struct snake_move *move)
+{
+	struct snake_cell head = snake_engine_cell(&game, game.head);
+
+	/* Finish a slide the frame timer did not complete. */
+	if (motion.q8 < MOTION_ONE) {
+		invalidate_cell(motion.head.x, motion.head.y);
+		if (motion.tail_active) {
+			invalidate_cell(motion.tail.x, motion.tail.y);
 		}
 	}
+
+	motion.head = head;
+	motion.head_edge = dir_between(head, snake_engine_cell(&game, snake_engine_slot(&game, 1)));
+	motion.tail_active = move->tail_vacated;
+	if (motion.tail_active) {
+		motion.tail = move->tail;
+		motion.tail_edge = dir_between(move->tail,
+					       snake_engine_cell(&game,
+								 snake_engine_slot(&game, game.len - 1)));
+	}
+
+	motion.start_ms = k_uptime_get_32();
+	motion.q8 = 0U;
 }
 
-static void update_objects(void)
+/* Runs at display rate; invalidates only the strips that changed. */
+static void motion_frame_cb(lv_timer_t *timer)
+{
+	uint32_t q8;
+	int prev;
+	int now;
+
+	ARG_UNUSED(timer);
+
+	if (motion.q8 >= MOTION_ONE) {
+		return;
+	}
+
+	q8 = MIN(((k_uptime_get_32() - motion.start_ms) * MOTION_ONE) / TICK_MS, MOTION_ONE);
+	if (q8 == motion.q8) {
+		return;
+	}
+
+	prev = motion_px(motion.q8);
+	now = motion_px(q8);
+	/* Leading strip of the head and trailing strip of the old tail. */
+	invalidate_strip(motion.head, motion.head_edge, prev, now);
+	if (motion.tail_active) {
+		invalidate_strip(motion.tail, motion.tail_edge, cell_draw_size() - now,
+				 cell_draw_size() - prev);
+	}
+
+	motion.q8 = q8;
+}
+#else
+static bool motion_covers(int x, int y)
 {
-	int draw = cell_size - 1;
+	ARG_UNUSED(x);
+	ARG_UNUSED(y);
 
-	if (draw < 1) {
-		draw = 1;
+	return false;
+}
+#endif
+
+/*
+ * Paint the snake and food cells inside the area LVGL is currently redrawing.
+ * The grid underneath comes from the object's tiled background image.
+ */
+static void board_draw_cb(lv_event_t *event)
+{
+	lv_layer_t *layer = lv_event_get_layer(event);
+	const lv_area_t *clip = &layer->_clip_area;
+	lv_draw_rect_dsc_t dsc;
+	lv_area_t area;
+	int cx1;
+	int cx2;
+	int cy1;
+	int cy2;
+
+	if (!clip_to_cells(clip->x1, clip->x2, origin_x, &cx1, &cx2) ||
+	    !clip_to_cells(clip->y1, clip->y2, origin_y, &cy1, &cy2)) {
+		return;
 	}
 
-	for (int i = 0; i < MAX_SNAKE_LEN; i++) {
-		if (i < snake_len) {
-			lv_obj_clear_flag(segments[i], LV_OBJ_FLAG_HIDDEN);
-			lv_obj_set_size(segments[i], draw, draw);
-			lv_obj_set_pos(segments[i],
-					   origin_x + snake[i].x * cell_size,
-					   origin_y + snake[i].y * cell_size);
-		} else {
-			lv_obj_add_flag(segments[i], LV_OBJ_FLAG_HIDDEN);
+	lv_draw_rect_dsc_init(&dsc);
+	dsc.radius = 0;
+	dsc.bg_opa = LV_OPA_COVER;
+	dsc.bg_color = lv_color_hex(SNAKE_COLOR_HEX);
+	for (int y = cy1; y <= cy2; y++) {
+		for (int x = cx1; x <= cx2; x++) {
+			if (snake_engine_occupied(&game, x, y) && !motion_covers(x, y)) {
+				cell_area(x, y, &area);
+				lv_draw_rect(layer, &dsc, &area);
+			}
 		}
 	}
 
-	lv_obj_set_size(food_obj, draw, draw);
-	lv_obj_set_pos(food_obj,
-			 origin_x + food.x * cell_size,
-			 origin_y + food.y * cell_size);
-	if (food_magic) {
-		lv_obj_set_style_bg_color(food_obj, lv_color_hex(0xf1c40f), 0);
-	} else {
-		lv_obj_set_style_bg_color(food_obj, lv_color_hex(0xe74c3c), 0);
+#if defined(CONFIG_APP_SNAKE_SMOOTH_MOTION)
+	if (motion.q8 < MOTION_ONE) {
+		int moved = motion_px(motion.q8);
+
+		cell_strip(motion.head, motion.head_edge, 0, moved, &area);
+		if ((moved > 0) && area_visible(&area, clip)) {
+			lv_draw_rect(layer, &dsc, &area);
+		}
+
+		cell_strip(motion.tail, motion.tail_edge, 0, cell_draw_size() - moved, &area);
+		if (motion.tail_active && area_visible(&area, clip)) {
+			lv_draw_rect(layer, &dsc, &area);
+		}
 	}
+#endif
 
-	lv_label_set_text_fmt(score_label, "Score: %d", score);
+	if ((game.food.x >= cx1) && (game.food.x <= cx2) && (game.food.y >= cy1) && (game.food.y <= cy2)) {
+		dsc.bg_color = food_color();
+		cell_area(game.food.x, game.food.y, &area);
+		lv_draw_rect(layer, &dsc, &area);
+	}
 }
 
-static void reset_game(void)
+static int board_create(lv_obj_t *screen, int border_w, lv_coord_t grid_px)
 {
-	snake_len = 3;
-	dir_x = 1;
-	dir_y = 0;
-	score = 0;
+	board_obj = lv_obj_create(screen);
+	lv_obj_set_pos(board_obj, origin_x - border_w, origin_y - border_w);
+	lv_obj_set_size(board_obj, grid_px, grid_px);
+	board_style(board_obj);
+	lv_obj_add_event_cb(board_obj, board_draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+	drawn_food = (struct snake_cell){ -1, -1 };
+	return 0;
+}
 
-	int start_x = GRID_SIZE / 2;
-	int start_y = GRID_SIZE / 2;
+static void board_show_segment(int slot)
+{
+	/* With smooth motion the head slides in through motion_frame_cb(). */
+	if (!IS_ENABLED(CONFIG_APP_SNAKE_SMOOTH_MOTION)) {
+		struct snake_cell cell = snake_engine_cell(&game, slot);
 
-	for (int i = 0; i < snake_len; i++) {
-		snake[i].x = start_x - i;
-		snake[i].y = start_y;
+		invalidate_cell(cell.x, cell.y);
 	}
+}
 
-	place_food();
-	update_objects();
+static void board_hide_segment(int slot, struct snake_cell cell)
+{
+	ARG_UNUSED(slot);
+
+	if (!IS_ENABLED(CONFIG_APP_SNAKE_SMOOTH_MOTION)) {
+		invalidate_cell(cell.x, cell.y);
+	}
+}
+
+static void board_update_food(void)
+{
+	invalidate_cell(drawn_food.x, drawn_food.y);
+	invalidate_cell(game.food.x, game.food.y);
+	drawn_food = game.food;
+}
+
+static void board_redraw(void)
+{
+	drawn_food = game.food;
+#if defined(CONFIG_APP_SNAKE_SMOOTH_MOTION)
+	motion.q8 = MOTION_ONE;
+#endif
+	lv_obj_invalidate(board_obj);
+}
+#endif
+
+#if !defined(CONFIG_APP_SNAKE_SMOOTH_MOTION)
+static void board_motion_start(const struct snake_move *move)
+{
+	ARG_UNUSED(move);
+}
+#endif
+
+/* Full refresh after a reset; ticks only update the head and tail. */
+static void update_objects(void)
+{
+	board_redraw();
+	lv_label_set_text_fmt(score_label, "Score: %d", game.score);
+}
+
+/*
+ * Queue a turn unless it repeats or reverses the direction the snake will
+ * have after the turns already queued. Holding a touch repeats the same
+ * direction, so only changes take a slot; turns beyond a full queue are
+ * dropped.
+ */
+static void dir_queue_push(enum snake_dir dir)
+{
+	enum snake_dir last = game.dir;
+
+	if (dir_queue_count > 0) {
+		last = dir_queue[(dir_queue_head + dir_queue_count - 1) %
+				 CONFIG_APP_SNAKE_INPUT_QUEUE_LEN];
+	}
+
+	if ((dir == last) || snake_dir_is_reverse(dir, last) ||
+	    (dir_queue_count == CONFIG_APP_SNAKE_INPUT_QUEUE_LEN)) {
+		return;
+	}
+
+	dir_queue[(dir_queue_head + dir_queue_count) % CONFIG_APP_SNAKE_INPUT_QUEUE_LEN] = dir;
+	dir_queue_count++;
+}
+
+#if !defined(CONFIG_APP_SNAKE_AUTOPILOT)
+/* The autopilot steers on its own and never drains the queue. */
+static enum snake_dir dir_queue_pop(void)
+{
+	enum snake_dir dir;
+
+	if (dir_queue_count == 0) {
+		return SNAKE_DIR_NONE;
+	}
+
+	dir = dir_queue[dir_queue_head];
+	dir_queue_head = (dir_queue_head + 1) % CONFIG_APP_SNAKE_INPUT_QUEUE_LEN;
+	dir_queue_count--;
+	return dir;
 }
+#endif
 
 static void update_direction_from_point(const lv_point_t *point)
 {
-	int head_px = origin_x + snake[0].x * cell_size + cell_size / 2;
-	int head_py = origin_y + snake[0].y * cell_size + cell_size / 2;
+	struct snake_cell head_cell = snake_engine_cell(&game, game.head);
+	const struct snake_cell *head = &head_cell;
+	int head_px = origin_x + head->x * cell_size + cell_size / 2;
+	int head_py = origin_y + head->y * cell_size + cell_size / 2;
 	int dx = point->x - head_px;
 	int dy = point->y - head_py;
 
@@ -160,25 +584,18 @@ static void update_direction_from_point(const lv_point_t *point)
 		return;
 	}
 
-	int ndx = 0;
-	int ndy = 0;
+	enum snake_dir dir;
 
 	int abs_dx = (dx < 0) ? -dx : dx;
 	int abs_dy = (dy < 0) ? -dy : dy;
 
 	if (abs_dx > abs_dy) {
-		ndx = (dx > 0) ? 1 : -1;
+		dir = (dx > 0) ? SNAKE_DIR_RIGHT : SNAKE_DIR_LEFT;
 	} else {
-		ndy = (dy > 0) ? 1 : -1;
-	}
-
-	if (ndx == -dir_x && ndy == -dir_y) {
-		return;
+		dir = (dy > 0) ? SNAKE_DIR_DOWN : SNAKE_DIR_UP;
 	}
 
-	pending_dir_x = ndx;
-	pending_dir_y = ndy;
-	pending_dir = true;
+	dir_queue_push(dir);
 }
 
 static void touch_event_cb(lv_event_t *event)
@@ -189,6 +606,11 @@ static void touch_event_cb(lv_event_t *event)
 		return;
 	}
 
+	/* The autopilot owns the direction; touches are ignored. */
+	if (IS_ENABLED(CONFIG_APP_SNAKE_AUTOPILOT)) {
+		return;
+	}
+
 	lv_point_t point;
 	lv_indev_t *indev = lv_event_get_indev(event);
 
@@ -200,54 +622,121 @@ static void touch_event_cb(lv_event_t *event)
 	update_direction_from_point(&point);
 }
 
+static void game_tick(void)
+{
+	struct snake_move move;
+	int score = game.score;
+	enum snake_tick_result result;
+	enum snake_dir turn;
+
+#if defined(CONFIG_APP_SNAKE_AUTOPILOT)
+	turn = snake_autopilot_next(&game);
+	soak_longest = MAX(soak_longest, game.len);
+#else
+	turn = dir_queue_pop();
+#endif
+
+	result = snake_engine_tick(&game, turn, &move);
+
+	if (result == SNAKE_TICK_RESET) {
+		/* Turns queued for the old round would misfire on the new one. */
+		dir_queue_count = 0;
+#if defined(CONFIG_APP_SNAKE_AUTOPILOT)
+		soak_rounds++;
+#endif
+		LOG_INF("Round over at tick %u, score %d (seed 0x%08x, %zu turns logged%s)",
+			game.tick, score, game_log.seed, game_log.count,
+			game_log.overflow ? ", log full" : "");
+		update_objects();
+		return;
+	}
+
+	/* At full length the new head reuses the tail slot and its object. */
+	if (move.tail_vacated && (move.tail_slot != game.head)) {
+		board_hide_segment(move.tail_slot, move.tail);
+	}
+	board_show_segment(game.head);
+	board_motion_start(&move);
+
+	if (result == SNAKE_TICK_ATE) {
+		board_update_food();
+		lv_label_set_text_fmt(score_label, "Score: %d", game.score);
+	}
+}
+
 static void game_tick_cb(lv_timer_t *timer)
 {
+	timing_t start = frame_stats_start();
+
 	ARG_UNUSED(timer);
 
-	if (pending_dir) {
-		dir_x = pending_dir_x;
-		dir_y = pending_dir_y;
-		pending_dir = false;
-	}
+	game_tick();
+	frame_stats_stop(FRAME_STAT_TICK, start);
+}
 
-	int next_x = snake[0].x + dir_x;
-	int next_y = snake[0].y + dir_y;
+#if defined(CONFIG_APP_SNAKE_AUTOPILOT)
+static void soak_report_cb(lv_timer_t *timer)
+{
+	struct sys_memory_stats stats;
 
-	if (next_x < 0 || next_y < 0 || next_x >= GRID_SIZE || next_y >= GRID_SIZE) {
-		reset_game();
-		return;
-	}
+	ARG_UNUSED(timer);
 
-	if (snake_contains(next_x, next_y)) {
-		reset_game();
-		return;
-	}
+	lvgl_heap_stats(&stats);
+	LOG_INF("Soak %u s: %u rounds, longest snake %d/%d, LVGL heap %zu used, %zu peak, "
+		"%zu free",
+		k_uptime_seconds(), soak_rounds, soak_longest, game.cells,
+		stats.allocated_bytes, stats.max_allocated_bytes, stats.free_bytes);
+}
+#endif
 
-	struct cell_pos tail_prev = snake[snake_len - 1];
+/* Size the board to the display and allocate the game state for it. */
+static int game_create(lv_coord_t usable, int border_w)
+{
+	size_t pool_size;
+	void *pool;
+	uint32_t seed;
+	int ret;
+
+	/* Even, so the autopilot's Hamiltonian cycle closes. */
+	grid_size = CLAMP((usable - (2 * border_w)) / CONFIG_APP_SNAKE_CELL_PX,
+			  SNAKE_BOARD_MIN, SNAKE_BOARD_MAX) & ~1;
+	cell_size = MAX((usable - (2 * border_w)) / grid_size, 1);
+
+	pool_size = SNAKE_ENGINE_POOL_SIZE(grid_size, grid_size);
+	pool = lv_malloc(pool_size);
+	if (pool == NULL) {
+		return -ENOMEM;
+	}
 
-	for (int i = snake_len - 1; i > 0; i--) {
-		snake[i] = snake[i - 1];
+	ret = snake_engine_setup(&game, grid_size, grid_size, pool, pool_size);
+	if (ret < 0) {
+		return ret;
 	}
 
-	snake[0].x = next_x;
-	snake[0].y = next_y;
+#if defined(CONFIG_APP_SNAKE_AUTOPILOT)
+	pool = lv_malloc(SNAKE_AUTOPILOT_SCRATCH_SIZE(grid_size, grid_size));
+	if (pool == NULL) {
+		return -ENOMEM;
+	}
 
-	if (next_x == food.x && next_y == food.y) {
-		int grow = food_magic ? food_bonus : 1;
-		for (int i = 0; i < grow; i++) {
-			if (snake_len < MAX_SNAKE_LEN) {
-				snake_len++;
-				snake[snake_len - 1] = tail_prev;
-			}
-		}
-		score += grow;
-		place_food();
+	ret = snake_autopilot_init(&game, pool);
+	if (ret < 0) {
+		return ret;
 	}
+	pool_size += SNAKE_AUTOPILOT_SCRATCH_SIZE(grid_size, grid_size);
+#endif
 
-	update_objects();
+	LOG_INF("Board %dx%d with %d px cells, %zu bytes of game state", grid_size, grid_size,
+		cell_size, pool_size);
+
+	seed = (CONFIG_APP_SNAKE_SEED != 0) ? CONFIG_APP_SNAKE_SEED : k_uptime_get_32();
+	LOG_INF("Game seed 0x%08x", seed);
+	snake_input_log_init(&game_log, game_inputs, ARRAY_SIZE(game_inputs));
+	snake_engine_init(&game, seed, &game_log);
+	return 0;
 }
 
-static void setup_ui(void)
+static int setup_ui(void)
 {
 	lv_obj_t *screen = lv_scr_act();
 	lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), 0);
@@ -259,74 +748,28 @@ static void setup_ui(void)
 	lv_coord_t usable = (size * 7) / 10;
 	const int border_w = 2;
 	lv_coord_t grid_px;
+	int ret;
 
-	cell_size = (usable - (2 * border_w)) / GRID_SIZE;
-	if (cell_size < 1) {
-		cell_size = 1;
+	ret = game_create(usable, border_w);
+	if (ret < 0) {
+		LOG_ERR("Game setup failed (%d)", ret);
+		return ret;
 	}
 
-	grid_px = cell_size * GRID_SIZE + (2 * border_w);
-	origin_x = (width - (cell_size * GRID_SIZE)) / 2;
-	origin_y = (height - (cell_size * GRID_SIZE)) / 2;
+	grid_px = cell_size * grid_size + (2 * border_w);
+	origin_x = (width - (cell_size * grid_size)) / 2;
+	origin_y = (height - (cell_size * grid_size)) / 2;
 
 	score_label = lv_label_create(screen);
 	lv_label_set_text(score_label, "Score: 0");
 	lv_obj_align(score_label, LV_ALIGN_TOP_MID, 0, 10);
 	lv_obj_set_style_text_color(score_label, lv_color_hex(0xffffff), 0);
 
-	grid_border = lv_obj_create(screen);
-	lv_obj_clear_flag(grid_border, LV_OBJ_FLAG_SCROLLABLE);
-	lv_obj_set_pos(grid_border, origin_x - border_w, origin_y - border_w);
-	lv_obj_set_size(grid_border, grid_px, grid_px);
-	lv_obj_set_style_radius(grid_border, 0, 0);
-	lv_obj_set_style_pad_all(grid_border, 0, 0);
-	lv_obj_set_style_bg_color(grid_border, lv_color_hex(0x111111), 0);
-	lv_obj_set_style_bg_opa(grid_border, LV_OPA_20, 0);
-	lv_obj_set_style_border_width(grid_border, 0, 0);
-
-	int line_idx = 0;
-	for (int i = 0; i <= GRID_SIZE; i++) {
-		int pos = border_w + i * cell_size;
-
-		grid_line_points[line_idx][0] = (lv_point_t){ pos, 0 };
-		grid_line_points[line_idx][1] =
-			(lv_point_t){ pos, grid_px };
-		grid_lines[line_idx] = lv_line_create(grid_border);
-		lv_line_set_points(grid_lines[line_idx], grid_line_points[line_idx], 2);
-		lv_obj_set_style_line_width(grid_lines[line_idx], 1, 0);
-		lv_obj_set_style_line_color(grid_lines[line_idx], lv_color_hex(GRID_LINE_COLOR_HEX), 0);
-		lv_obj_set_style_line_opa(grid_lines[line_idx], LV_OPA_40, 0);
-		line_idx++;
-
-		grid_line_points[line_idx][0] = (lv_point_t){ 0, pos };
-		grid_line_points[line_idx][1] =
-			(lv_point_t){ grid_px, pos };
-		grid_lines[line_idx] = lv_line_create(grid_border);
-		lv_line_set_points(grid_lines[line_idx], grid_line_points[line_idx], 2);
-		lv_obj_set_style_line_width(grid_lines[line_idx], 1, 0);
-		lv_obj_set_style_line_color(grid_lines[line_idx], lv_color_hex(GRID_LINE_COLOR_HEX), 0);
-		lv_obj_set_style_line_opa(grid_lines[line_idx], LV_OPA_40, 0);
-		line_idx++;
-	}
-
-	for (int i = 0; i < MAX_SNAKE_LEN; i++) {
-		segments[i] = lv_obj_create(screen);
-		lv_obj_clear_flag(segments[i], LV_OBJ_FLAG_SCROLLABLE);
-		lv_obj_set_style_radius(segments[i], 0, 0);
-		lv_obj_set_style_border_width(segments[i], 0, 0);
-		lv_obj_set_style_bg_color(segments[i], lv_color_hex(0x2ecc71), 0);
-		lv_obj_add_flag(segments[i], LV_OBJ_FLAG_HIDDEN);
-	}
-
-	food_obj = lv_obj_create(screen);
-	lv_obj_clear_flag(food_obj, LV_OBJ_FLAG_SCROLLABLE);
-	lv_obj_set_style_radius(food_obj, 0, 0);
-	lv_obj_set_style_border_width(food_obj, 0, 0);
-	lv_obj_set_style_bg_color(food_obj, lv_color_hex(0xe74c3c), 0);
-
-	rand_state = (uint32_t)k_uptime_get_32();
-	if (rand_state == 0) {
-		rand_state = 1;
+	grid_tile_create(screen, border_w);
+	ret = board_create(screen, border_w, grid_px);
+	if (ret < 0) {
+		LOG_ERR("Board setup failed (%d)", ret);
+		return ret;
 	}
 
 	/* Legend in the left margin between display edge and grid area. */
@@ -383,8 +826,27 @@ static void setup_ui(void)
 	lv_obj_add_event_cb(touch_layer, touch_event_cb, LV_EVENT_ALL, NULL);
 	lv_obj_move_foreground(touch_layer);
 
-	reset_game();
+	update_objects();
 	lv_timer_create(game_tick_cb, TICK_MS, NULL);
+#if defined(CONFIG_APP_SNAKE_SMOOTH_MOTION)
+	lv_timer_create(motion_frame_cb, CONFIG_APP_SNAKE_SMOOTH_FRAME_MS, NULL);
+#endif
+#if defined(CONFIG_APP_SNAKE_AUTOPILOT)
+	lv_timer_create(soak_report_cb, CONFIG_APP_SNAKE_SOAK_REPORT_S * MSEC_PER_SEC, NULL);
+#endif
+	return 0;
+}
+
+/* Compare renderers: object count on the screen and LVGL pool usage. */
+static void log_ui_memory(void)
+{
+	struct sys_memory_stats stats;
+
+	lvgl_heap_stats(&stats);
+	LOG_INF("%s renderer: %u screen objects, LVGL heap %zu used, %zu peak",
+		IS_ENABLED(CONFIG_APP_SNAKE_RENDER_OBJECTS) ? "Object" : "Draw",
+		(unsigned int)lv_obj_get_child_count(lv_screen_active()),
+		stats.allocated_bytes, stats.max_allocated_bytes);
 }
 
 int main(void)
@@ -416,10 +878,18 @@ int main(void)
 
 	display_blanking_off(display);
 
-	setup_ui();
+	if (setup_ui() < 0) {
+		return 0;
+	}
+
+	log_ui_memory();
+	frame_stats_init();
 
 	while (1) {
+		timing_t start = frame_stats_start();
+
 		lv_timer_handler();
+		frame_stats_stop(FRAME_STAT_TIMER_HANDLER, start);
 		k_msleep(10);
 	}
 }
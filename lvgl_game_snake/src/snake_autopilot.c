@@ -0,0 +1,200 @@
+#include "snake_autopilot.h"
+
+#include <errno.h>
+
+#define DIR_COUNT 4
+
+/* order[] value of the one cell an odd-by-odd board leaves off the cycle. */
+#define OFF_CYCLE UINT16_MAX
+
+static const enum snake_dir dirs[DIR_COUNT] = {
+	SNAKE_DIR_UP,
+	SNAKE_DIR_DOWN,
+	SNAKE_DIR_LEFT,
+	SNAKE_DIR_RIGHT,
+};
+
+/* Position of every cell along the Hamiltonian cycle. */
+static uint16_t *order;
+static int cycle_len;
+/* Set once the cycle direction has been matched to the starting body. */
+static bool oriented;
+
+static inline int cell_index(const struct snake_engine *engine, int x, int y)
+{
+	return (y * engine->width) + x;
+}
+
+static bool on_board(const struct snake_engine *engine, int x, int y)
+{
+	return (x >= 0) && (y >= 0) && (x < engine->width) && (y < engine->height);
+}
+
+/*
+ * Cycle: row 0 left to right, then the remaining rows in a zigzag over
+ * columns 1..width-1, and back up column 0. An odd height ends the zigzag
+ * two rows early and covers the last two rows column by column instead,
+ * skipping the bottom-right corner, which never holds food.
+ */
+static enum snake_dir cycle_dir(const struct snake_engine *engine, int x, int y)
+{
+	int pair_row = ((engine->height % 2) != 0) ? (engine->height - 2) : engine->height;
+
+	if (x == 0) {
+		return (y == 0) ? SNAKE_DIR_RIGHT : SNAKE_DIR_UP;
+	}
+
+	if (y >= pair_row) {
+		if (x == engine->width - 1) {
+			return (y == pair_row) ? SNAKE_DIR_LEFT : SNAKE_DIR_NONE;
+		}
+
+		/* Columns alternate down and up, starting down next to the corner. */
+		if (((engine->width - 2 - x) % 2) == 0) {
+			return (y == pair_row) ? SNAKE_DIR_DOWN : SNAKE_DIR_LEFT;
+		}
+
+		return (y == pair_row) ? SNAKE_DIR_LEFT : SNAKE_DIR_UP;
+	}
+
+	if ((y % 2) == 0) {
+		return (x == engine->width - 1) ? SNAKE_DIR_DOWN : SNAKE_DIR_RIGHT;
+	}
+
+	if ((x == 1) && (y != engine->height - 1)) {
+		return SNAKE_DIR_DOWN;
+	}
+
+	return SNAKE_DIR_LEFT;
+}
+
+int snake_autopilot_init(const struct snake_engine *engine, void *scratch)
+{
+	int x = 0;
+	int y = 0;
+
+	/* The zigzag cannot close over an odd height with an even width. */
+	if (((engine->height % 2) != 0) && ((engine->width % 2) == 0)) {
+		return -EINVAL;
+	}
+
+	order = scratch;
+	oriented = false;
+	cycle_len = 0;
+
+	for (int i = 0; i < engine->cells; i++) {
+		order[i] = OFF_CYCLE;
+	}
+
+	do {
+		enum snake_dir dir = cycle_dir(engine, x, y);
+
+		order[cell_index(engine, x, y)] = (uint16_t)cycle_len++;
+		x += snake_dir_dx(dir);
+		y += snake_dir_dy(dir);
+	} while ((x != 0) || (y != 0));
+
+	return 0;
+}
+
+/* Steps from cell from to cell to, moving forward along the cycle. */
+static int cycle_dist(int from, int to)
+{
+	return ((int)order[to] - (int)order[from] + cycle_len) % cycle_len;
+}
+
+/*
+ * Run the cycle in whichever direction passes tail, neck and head in that
+ * order, so the starting body already lies along it.
+ */
+static void orient(const struct snake_engine *engine)
+{
+	int head = engine->body[engine->head];
+	int neck = engine->body[snake_engine_slot(engine, 1)];
+	int tail = engine->body[snake_engine_slot(engine, engine->len - 1)];
+
+	if (cycle_dist(tail, neck) > cycle_dist(tail, head)) {
+		for (int i = 0; i < engine->cells; i++) {
+			if (order[i] != OFF_CYCLE) {
+				order[i] = (uint16_t)(cycle_len - 1 - order[i]);
+			}
+		}
+	}
+
+	oriented = true;
+}
+
+/* With no food left, run into the body or a wall so a new round starts. */
+static enum snake_dir end_round(const struct snake_engine *engine, int hx, int hy)
+{
+	for (int i = 0; i < DIR_COUNT; i++) {
+		int nx = hx + snake_dir_dx(dirs[i]);
+		int ny = hy + snake_dir_dy(dirs[i]);
+
+		if (!snake_dir_is_reverse(dirs[i], engine->dir) &&
+		    (!on_board(engine, nx, ny) || snake_engine_occupied(engine, nx, ny))) {
+			return dirs[i];
+		}
+	}
+
+	return SNAKE_DIR_NONE;
+}
+
+enum snake_dir snake_autopilot_next(const struct snake_engine *engine)
+{
+	int head = engine->body[engine->head];
+	int tail = engine->body[snake_engine_slot(engine, engine->len - 1)];
+	int hx = head % engine->width;
+	int hy = head / engine->width;
+	int max_skip = 0;
+	int best_dist = 0;
+	enum snake_dir best = SNAKE_DIR_NONE;
+
+	if (!oriented) {
+		orient(engine);
+	}
+
+	/*
+	 * The body always lies along the cycle from tail to head, so the next
+	 * cycle cell is free. A shortcut may only land ahead of the head and no
+	 * further than the food, and only while the stretch of cycle from tail
+	 * to the new head, plus the growth still to come from pending segments
+	 * and the food, stays within half the cycle. Past that the snake follows
+	 * the cycle until the gaps shortcuts left in its body have drained.
+	 */
+	if (engine->food.x >= 0) {
+		int to_food = cycle_dist(head, cell_index(engine, engine->food.x, engine->food.y));
+		int span = cycle_len - cycle_dist(head, tail) + 1;
+
+		max_skip = (cycle_len / 2) - span - engine->grow_pending - engine->food_bonus;
+		if (to_food < max_skip) {
+			max_skip = to_food;
+		}
+	} else if (engine->grow_pending == 0) {
+		return end_round(engine, hx, hy);
+	}
+
+	for (int i = 0; i < DIR_COUNT; i++) {
+		int nx = hx + snake_dir_dx(dirs[i]);
+		int ny = hy + snake_dir_dy(dirs[i]);
+		int next;
+		int dist;
+
+		if (!on_board(engine, nx, ny) || snake_engine_occupied(engine, nx, ny)) {
+			continue;
+		}
+
+		next = cell_index(engine, nx, ny);
+		if (order[next] == OFF_CYCLE) {
+			continue;
+		}
+
+		dist = cycle_dist(head, next);
+		if ((dist > best_dist) && ((dist == 1) || (dist <= max_skip))) {
+			best_dist = dist;
+			best = dirs[i];
+		}
+	}
+
+	return best;
+}
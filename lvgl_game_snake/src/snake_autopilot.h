@@ -0,0 +1,24 @@
+#ifndef SNAKE_AUTOPILOT_H
+#define SNAKE_AUTOPILOT_H
+
+#include "snake_engine.h"
+
+/* Scratch bytes snake_autopilot_init() needs for a board of this size. */
+#define SNAKE_AUTOPILOT_SCRATCH_SIZE(width, height) \
+	((size_t)(width) * (height) * sizeof(uint16_t))
+
+/*
+ * Lay a Hamiltonian cycle over the engine's board in scratch, which must
+ * hold SNAKE_AUTOPILOT_SCRATCH_SIZE() bytes. Returns -EINVAL for an odd
+ * height with an even width; odd-by-odd boards leave one corner unused.
+ */
+int snake_autopilot_init(const struct snake_engine *engine, void *scratch);
+
+/*
+ * Pick the next turn for the engine: follow the cycle, cutting across it
+ * towards the food only where the body stays in cycle order behind the
+ * head, so the snake can grow until the food area is full.
+ */
+enum snake_dir snake_autopilot_next(const struct snake_engine *engine);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef SNAKE_BENCH_H
+#define SNAKE_BENCH_H
+
+/*
+ * Run the engine headless with scripted random turns, log ticks per second,
+ * then replay the recorded inputs and check the final state hash matches.
+ * Returns 0 when the replay is bit-exact.
+ */
+int snake_bench_run(void);
+
+#endif
@@ -0,0 +1,292 @@
+#include "snake_engine.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define OCCUPIED_BIT(idx) (1U << ((idx) % 32))
+
+static uint32_t prng_next(struct snake_engine *engine)
+{
+	engine->rand_state ^= engine->rand_state << 13;
+	engine->rand_state ^= engine->rand_state >> 17;
+	engine->rand_state ^= engine->rand_state << 5;
+	return engine->rand_state;
+}
+
+static inline int cell_index(const struct snake_engine *engine, int x, int y)
+{
+	return (y * engine->width) + x;
+}
+
+static bool is_food_cell(const struct snake_engine *engine, int x, int y)
+{
+	return (x >= 1) && (y >= 1) && (x <= engine->width - 2) && (y <= engine->height - 2);
+}
+
+static void occupy_cell(struct snake_engine *engine, int x, int y)
+{
+	int idx = cell_index(engine, x, y);
+	int slot = engine->free_slot[idx];
+
+	engine->occupied[idx / 32] |= OCCUPIED_BIT(idx);
+
+	if (slot >= 0) {
+		/* Swap the last free cell into the vacated slot. */
+		int last = engine->free_cells[--engine->free_count];
+
+		engine->free_cells[slot] = (uint16_t)last;
+		engine->free_slot[last] = (int16_t)slot;
+		engine->free_slot[idx] = -1;
+	}
+}
+
+static void vacate_cell(struct snake_engine *engine, int x, int y)
+{
+	int idx = cell_index(engine, x, y);
+
+	engine->occupied[idx / 32] &= ~OCCUPIED_BIT(idx);
+
+	if (is_food_cell(engine, x, y)) {
+		engine->free_slot[idx] = (int16_t)engine->free_count;
+		engine->free_cells[engine->free_count++] = (uint16_t)idx;
+	}
+}
+
+static void clear_occupancy(struct snake_engine *engine)
+{
+	memset(engine->occupied, 0, ((engine->cells + 31) / 32) * sizeof(uint32_t));
+	engine->free_count = 0;
+
+	for (int y = 0; y < engine->height; y++) {
+		for (int x = 0; x < engine->width; x++) {
+			engine->free_slot[cell_index(engine, x, y)] = -1;
+			if (is_food_cell(engine, x, y)) {
+				vacate_cell(engine, x, y);
+			}
+		}
+	}
+}
+
+static void place_food(struct snake_engine *engine)
+{
+	int idx;
+
+	if (engine->free_count == 0) {
+		/* No free cell left in the food area; the board is won. */
+		engine->food.x = -1;
+		engine->food.y = -1;
+		return;
+	}
+
+	/* 1 in 6 chance for magic food. */
+	engine->food_magic = ((prng_next(engine) % 6U) == 0U);
+	engine->food_bonus = engine->food_magic ? (int)(1 + (prng_next(engine) % 3U)) : 1;
+
+	idx = engine->free_cells[prng_next(engine) % (uint32_t)engine->free_count];
+	engine->food.x = idx % engine->width;
+	engine->food.y = idx / engine->width;
+}
+
+static void log_input(struct snake_engine *engine, enum snake_dir dir)
+{
+	struct snake_input_log *log = engine->log;
+
+	if (log == NULL) {
+		return;
+	}
+
+	if (log->count >= log->capacity) {
+		log->overflow = true;
+		return;
+	}
+
+	log->inputs[log->count].tick = engine->tick;
+	log->inputs[log->count].dir = (uint8_t)dir;
+	log->count++;
+}
+
+int snake_engine_setup(struct snake_engine *engine, int width, int height, void *pool,
+		       size_t pool_size)
+{
+	uint8_t *next = pool;
+
+	if ((width < SNAKE_BOARD_MIN) || (height < SNAKE_BOARD_MIN) ||
+	    (width > SNAKE_BOARD_MAX) || (height > SNAKE_BOARD_MAX)) {
+		return -EINVAL;
+	}
+
+	if (pool_size < SNAKE_ENGINE_POOL_SIZE(width, height)) {
+		return -ENOMEM;
+	}
+
+	memset(engine, 0, sizeof(*engine));
+	engine->width = width;
+	engine->height = height;
+	engine->cells = width * height;
+
+	/* Widest alignment first so each array stays naturally aligned. */
+	engine->occupied = (uint32_t *)next;
+	next += ((size_t)(engine->cells + 31) / 32U) * sizeof(uint32_t);
+	engine->body = (uint16_t *)next;
+	next += (size_t)engine->cells * sizeof(uint16_t);
+	engine->free_slot = (int16_t *)next;
+	next += (size_t)engine->cells * sizeof(int16_t);
+	engine->free_cells = (uint16_t *)next;
+	return 0;
+}
+
+void snake_engine_init(struct snake_engine *engine, uint32_t seed,
+		       struct snake_input_log *log)
+{
+	engine->tick = 0U;
+	engine->food_magic = false;
+	engine->food_bonus = 0;
+	engine->rand_state = (seed != 0U) ? seed : 1U;
+	engine->log = log;
+
+	if (log != NULL) {
+		log->seed = seed;
+		log->count = 0U;
+		log->overflow = false;
+	}
+
+	snake_engine_reset(engine);
+}
+
+void snake_engine_reset(struct snake_engine *engine)
+{
+	int start_x = engine->width / 2;
+	int start_y = engine->height / 2;
+
+	engine->len = 3;
+	engine->dir = SNAKE_DIR_RIGHT;
+	engine->score = 0;
+	engine->grow_pending = 0;
+
+	clear_occupancy(engine);
+	engine->head = 0;
+	for (int i = 0; i < engine->len; i++) {
+		engine->body[i] = (uint16_t)cell_index(engine, start_x - i, start_y);
+		occupy_cell(engine, start_x - i, start_y);
+	}
+
+	place_food(engine);
+}
+
+enum snake_tick_result snake_engine_tick(struct snake_engine *engine, enum snake_dir turn,
+					 struct snake_move *move)
+{
+	struct snake_move local;
+	int next_x;
+	int next_y;
+	bool grow;
+
+	if (move == NULL) {
+		move = &local;
+	}
+
+	if ((turn != SNAKE_DIR_NONE) && (turn != engine->dir) &&
+	    !snake_dir_is_reverse(turn, engine->dir)) {
+		engine->dir = turn;
+		log_input(engine, turn);
+	}
+
+	engine->tick++;
+
+	next_x = (engine->body[engine->head] % engine->width) + snake_dir_dx(engine->dir);
+	next_y = (engine->body[engine->head] / engine->width) + snake_dir_dy(engine->dir);
+
+	if ((next_x < 0) || (next_y < 0) || (next_x >= engine->width) ||
+	    (next_y >= engine->height) || snake_engine_occupied(engine, next_x, next_y)) {
+		snake_engine_reset(engine);
+		return SNAKE_TICK_RESET;
+	}
+
+	move->tail_slot = snake_engine_slot(engine, engine->len - 1);
+	move->tail = snake_engine_cell(engine, move->tail_slot);
+	grow = (engine->grow_pending > 0) && (engine->len < engine->cells);
+
+	engine->head = (engine->head + engine->cells - 1) % engine->cells;
+	engine->body[engine->head] = (uint16_t)cell_index(engine, next_x, next_y);
+
+	/* Growth keeps the tail in place for one tick per pending segment. */
+	if (grow) {
+		engine->len++;
+		engine->grow_pending--;
+		move->tail_vacated = false;
+	} else {
+		vacate_cell(engine, move->tail.x, move->tail.y);
+		move->tail_vacated = true;
+	}
+	occupy_cell(engine, next_x, next_y);
+
+	if ((next_x == engine->food.x) && (next_y == engine->food.y)) {
+		int bonus = engine->food_magic ? engine->food_bonus : 1;
+
+		engine->grow_pending += bonus;
+		engine->score += bonus;
+		place_food(engine);
+		return SNAKE_TICK_ATE;
+	}
+
+	return SNAKE_TICK_MOVED;
+}
+
+bool snake_engine_occupied(const struct snake_engine *engine, int x, int y)
+{
+	int idx = cell_index(engine, x, y);
+
+	return (engine->occupied[idx / 32] & OCCUPIED_BIT(idx)) != 0U;
+}
+
+static uint32_t fnv1a(uint32_t hash, uint32_t value)
+{
+	for (int i = 0; i < 4; i++) {
+		hash ^= (value >> (i * 8)) & 0xffU;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+uint32_t snake_engine_hash(const struct snake_engine *engine)
+{
+	uint32_t hash = 2166136261U;
+
+	for (int i = 0; i < engine->len; i++) {
+		hash = fnv1a(hash, engine->body[snake_engine_slot(engine, i)]);
+	}
+
+	hash = fnv1a(hash, (uint32_t)engine->food.x);
+	hash = fnv1a(hash, (uint32_t)engine->food.y);
+	hash = fnv1a(hash, (uint32_t)engine->score);
+	hash = fnv1a(hash, engine->tick);
+	return fnv1a(hash, engine->rand_state);
+}
+
+void snake_input_log_init(struct snake_input_log *log, struct snake_input *buf,
+			  size_t capacity)
+{
+	memset(log, 0, sizeof(*log));
+	log->inputs = buf;
+	log->capacity = capacity;
+}
+
+void snake_engine_replay(struct snake_engine *engine, const struct snake_input_log *log,
+			 uint32_t ticks)
+{
+	size_t next = 0U;
+
+	snake_engine_init(engine, log->seed, NULL);
+
+	while (engine->tick < ticks) {
+		enum snake_dir turn = SNAKE_DIR_NONE;
+
+		/* A turn logged at tick t was applied by the call that made it t + 1. */
+		if ((next < log->count) && (log->inputs[next].tick == engine->tick)) {
+			turn = (enum snake_dir)log->inputs[next++].dir;
+		}
+
+		(void)snake_engine_tick(engine, turn, NULL);
+	}
+}
@@ -0,0 +1,176 @@
+#ifndef SNAKE_ENGINE_H
+#define SNAKE_ENGINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Snake rules without any LVGL or kernel dependency: movement, collision,
+ * growth and food placement from an explicitly seeded PRNG. Given the same
+ * seed and the same inputs on the same ticks, two engines stay bit-exact.
+ */
+
+/* Board limits; cell indices must fit in 16 bits. */
+#define SNAKE_BOARD_MIN 4
+#define SNAKE_BOARD_MAX 128
+
+/* Food spawns away from the outermost grid border (1..width-2, 1..height-2). */
+#define SNAKE_FOOD_CELLS(width, height) (((width) - 2) * ((height) - 2))
+
+/*
+ * Bytes of board storage for snake_engine_setup(): the occupancy bitmap,
+ * the body ring (one cell index per cell, so the snake can fill the board)
+ * and the free-cell set.
+ */
+#define SNAKE_ENGINE_POOL_SIZE(width, height)                                          \
+	(((((size_t)(width) * (height) + 31U) / 32U) * sizeof(uint32_t)) +             \
+	 ((size_t)(width) * (height) * sizeof(uint16_t)) +                             \
+	 ((size_t)SNAKE_FOOD_CELLS(width, height) * sizeof(uint16_t)) +                \
+	 ((size_t)(width) * (height) * sizeof(int16_t)))
+
+enum snake_dir {
+	SNAKE_DIR_NONE,
+	SNAKE_DIR_UP,
+	SNAKE_DIR_DOWN,
+	SNAKE_DIR_LEFT,
+	SNAKE_DIR_RIGHT,
+};
+
+enum snake_tick_result {
+	SNAKE_TICK_MOVED,
+	SNAKE_TICK_ATE,
+	/* Hit a wall or the body; the engine has already started a new round. */
+	SNAKE_TICK_RESET,
+};
+
+struct snake_cell {
+	int x;
+	int y;
+};
+
+/* A direction change applied on a given tick. */
+struct snake_input {
+	uint32_t tick;
+	uint8_t dir;
+};
+
+/* Seed plus every applied turn, enough to replay a session. */
+struct snake_input_log {
+	uint32_t seed;
+	struct snake_input *inputs;
+	size_t capacity;
+	size_t count;
+	/* Set once an input did not fit; replay then diverges after it. */
+	bool overflow;
+};
+
+/* What changed on the board during one tick, for incremental redraws. */
+struct snake_move {
+	/* Body slot and cell of the tail before the move. */
+	int tail_slot;
+	struct snake_cell tail;
+	/* False while growing, when the tail stays in place. */
+	bool tail_vacated;
+};
+
+struct snake_engine {
+	int width;
+	int height;
+	/* width * height; also the body ring size, so there is no length cap. */
+	int cells;
+
+	/*
+	 * Circular body of cell indices (x + y * width): the head lives at
+	 * body[head] and segment i at (head + i) % cells. Use
+	 * snake_engine_cell() for coordinates.
+	 */
+	uint16_t *body;
+	int head;
+	int len;
+	enum snake_dir dir;
+	int grow_pending;
+	/* x is -1 when the food area is full and the board is won. */
+	struct snake_cell food;
+	bool food_magic;
+	int food_bonus;
+	int score;
+	uint32_t tick;
+	uint32_t rand_state;
+	struct snake_input_log *log;
+
+	/* One bit per grid cell, set while a snake segment covers it. */
+	uint32_t *occupied;
+	/*
+	 * Food-eligible cells not covered by the snake, kept as a dense array
+	 * so a uniform pick is one index. free_slot[] maps a cell index to its
+	 * position in free_cells[], or -1 when the cell is occupied or outside
+	 * the food area.
+	 */
+	uint16_t *free_cells;
+	int16_t *free_slot;
+	int free_count;
+};
+
+static inline int snake_dir_dx(enum snake_dir dir)
+{
+	return (dir == SNAKE_DIR_RIGHT) ? 1 : ((dir == SNAKE_DIR_LEFT) ? -1 : 0);
+}
+
+static inline int snake_dir_dy(enum snake_dir dir)
+{
+	return (dir == SNAKE_DIR_DOWN) ? 1 : ((dir == SNAKE_DIR_UP) ? -1 : 0);
+}
+
+static inline bool snake_dir_is_reverse(enum snake_dir a, enum snake_dir b)
+{
+	return (snake_dir_dx(a) == -snake_dir_dx(b)) && (snake_dir_dy(a) == -snake_dir_dy(b)) &&
+	       (a != SNAKE_DIR_NONE);
+}
+
+static inline int snake_engine_slot(const struct snake_engine *engine, int i)
+{
+	return (engine->head + i) % engine->cells;
+}
+
+static inline struct snake_cell snake_engine_cell(const struct snake_engine *engine, int slot)
+{
+	return (struct snake_cell){ engine->body[slot] % engine->width,
+				    engine->body[slot] / engine->width };
+}
+
+/*
+ * Set the board size and carve its storage out of pool, which must hold
+ * SNAKE_ENGINE_POOL_SIZE(width, height) bytes, 4-byte aligned.
+ * Returns -EINVAL for an unsupported size and -ENOMEM for a short pool.
+ */
+int snake_engine_setup(struct snake_engine *engine, int width, int height, void *pool,
+		       size_t pool_size);
+
+/* Seed the PRNG (0 is replaced by 1) and start the first round. */
+void snake_engine_init(struct snake_engine *engine, uint32_t seed,
+		       struct snake_input_log *log);
+
+/* Start a new round; the PRNG continues from its current state. */
+void snake_engine_reset(struct snake_engine *engine);
+
+/*
+ * Advance one cell. turn is applied first unless it is SNAKE_DIR_NONE or
+ * reverses the current direction. move may be NULL.
+ */
+enum snake_tick_result snake_engine_tick(struct snake_engine *engine, enum snake_dir turn,
+					 struct snake_move *move);
+
+bool snake_engine_occupied(const struct snake_engine *engine, int x, int y);
+
+/* FNV-1a over the body, food, score and PRNG state. */
+uint32_t snake_engine_hash(const struct snake_engine *engine);
+
+void snake_input_log_init(struct snake_input_log *log, struct snake_input *buf,
+			  size_t capacity);
+
+/* Re-run a logged session for ticks ticks from its seed. */
+void snake_engine_replay(struct snake_engine *engine, const struct snake_input_log *log,
+			 uint32_t ticks);
+
+#endif